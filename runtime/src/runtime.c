@@ -0,0 +1,38 @@
+// Runtime of the executables compiled by skarnc, see codegen/Runtime.h for the symbols.
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// println writes to stdout, the context is not used
+const char skarn_context = 0;
+
+void skarn_println(void* context, const char* format, int64_t count, ...) {
+    (void)context;
+
+    va_list args;
+    va_start(args, count);
+    for (const char* chr = format; *chr != '\0'; ++chr) {
+        if (chr[0] == '{' && chr[1] == '}') {
+            printf("%" PRId64, va_arg(args, int64_t));
+            ++chr;
+        }
+        else if ((chr[0] == '{' && chr[1] == '{') || (chr[0] == '}' && chr[1] == '}')) {
+            putchar(*chr++);
+        }
+        else {
+            putchar(*chr);
+        }
+    }
+
+    va_end(args);
+    putchar('\n');
+}
+
+void skarn_panic(const char* message) {
+    fflush(stdout);
+    fprintf(stderr, "error: %s\n", message);
+    exit(1);
+}
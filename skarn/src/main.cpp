@@ -1,7 +1,76 @@
+#include "ast/Analysis.h"
+#include "ast/ParallelParser.h"
+#include "bytecode/Compiler.h"
+#include "bytecode/Disassembler.h"
+#include "bytecode/Vm.h"
+#include "interpreter/Interpreter.h"
+#include "SourceFile.h"
+#ifdef SKARN_ENABLE_LLVM
+#include "codegen/Jit.h"
+#endif
+#include <exception>
+#include <iostream>
+#include <optional>
 #include <print>
+#include <string>
+#include <string_view>
 
-int main()
+int main(const int argc, char* argv[])
 {
-    std::println("Hello, world!");
-    return 0;
+    const std::string_view mode = argc == 3 ? argv[1] : "";
+    if (argc < 2 || argc > 3 || !mode.empty() && mode != "--interpret" && mode != "--disassemble" && mode != "--jit") {
+        std::println(stderr, "Usage: skarn [--interpret | --disassemble | --jit] <source file>");
+        return 1;
+    }
+
+    const char* const path = argv[argc - 1];
+    const std::optional<skarn::SourceFile> source = skarn::SourceFile::open(path);
+    if (!source) {
+        std::println(stderr, "{}: cannot open the file", path);
+        return 1;
+    }
+
+    skarn::ThreadPool pool;
+    auto unit = skarn::ast::parse_unit(source->text(), pool);
+    if (!unit) {
+        for (const skarn::parser::ParserMessage& message : unit.error()) {
+            std::println(stderr, "{}:{}:{}: error: expected {}", path, message.line, message.column, message.expected);
+        }
+
+        return 1;
+    }
+
+    try {
+        for (const std::string& warning : skarn::ast::analyze(*unit, pool)) {
+            std::println(stderr, "{}: warning: {}", path, warning);
+        }
+
+        if (mode == "--interpret") {
+            skarn::interpreter::Interpreter interpreter {*unit, std::cout};
+            return static_cast<int>(interpreter.run());
+        }
+
+        if (mode == "--jit") {
+#ifdef SKARN_ENABLE_LLVM
+            skarn::codegen::Jit jit {*unit, std::cout};
+            return static_cast<int>(jit.run());
+#else
+            std::println(stderr, "skarn is built without LLVM, configure with SKARN_ENABLE_LLVM=ON");
+            return 1;
+#endif
+        }
+
+        const skarn::bytecode::Program program = skarn::bytecode::compile(*unit, pool);
+        if (mode == "--disassemble") {
+            std::cout << skarn::bytecode::disassemble(program);
+            return 0;
+        }
+
+        skarn::bytecode::Vm vm {program, std::cout};
+        return static_cast<int>(vm.run());
+    }
+    catch (const std::exception& e) {
+        std::println(stderr, "{}: error: {}", path, e.what());
+        return 1;
+    }
 }
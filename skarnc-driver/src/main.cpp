@@ -0,0 +1,208 @@
+#include "ast/Analysis.h"
+#include "ast/ParallelParser.h"
+#include "codegen/IrGenerator.h"
+#include "codegen/ObjectEmitter.h"
+#include "codegen/Optimizer.h"
+#include "SourceFile.h"
+#include <llvm/Support/Program.h>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <print>
+#include <random>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+enum class Output {
+    Executable,
+    Object,
+    Assembly,
+    Ir,
+};
+
+struct Options {
+    Output output {Output::Executable};
+    llvm::OptimizationLevel level {llvm::OptimizationLevel::O2};
+    std::string source;
+    std::string target;
+};
+
+std::optional<Options> parse_options(const int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "-O0") {
+            options.level = llvm::OptimizationLevel::O0;
+        }
+        else if (arg == "-O1") {
+            options.level = llvm::OptimizationLevel::O1;
+        }
+        else if (arg == "-O2") {
+            options.level = llvm::OptimizationLevel::O2;
+        }
+        else if (arg == "-O3") {
+            options.level = llvm::OptimizationLevel::O3;
+        }
+        else if (arg == "-c") {
+            options.output = Output::Object;
+        }
+        else if (arg == "-S") {
+            options.output = Output::Assembly;
+        }
+        else if (arg == "--emit-llvm") {
+            options.output = Output::Ir;
+        }
+        else if (arg == "-o" && i + 1 < argc) {
+            options.target = argv[++i];
+        }
+        else if ((!arg.starts_with('-') || arg == "-") && options.source.empty()) {
+            options.source = arg;
+        }
+        else {
+            return std::nullopt;
+        }
+    }
+
+    if (options.source.empty() || options.source == "-" && options.target.empty()) {
+        return std::nullopt;
+    }
+
+    if (options.target.empty()) {
+        constexpr std::string_view extensions[] {"", ".o", ".s", ".ll"};
+        std::filesystem::path target = std::filesystem::path {options.source}.stem();
+        target += extensions[static_cast<size_t>(options.output)];
+        options.target = target.string();
+    }
+
+    return options;
+}
+
+void write(const std::string& path, const auto& writer) {
+    std::error_code error;
+    llvm::raw_fd_ostream out {path, error};
+    if (error) {
+        throw std::runtime_error {std::format("{}: cannot open the file: {}", path, error.message())};
+    }
+
+    writer(out);
+}
+
+/// The C compiler driver links the object with the runtime, CC overrides it. The compiler is run without a shell,
+/// so paths are passed verbatim; CC is split at spaces to allow a launcher or options, e.g. "ccache cc".
+void link(const std::string& object, const std::string& target) {
+    const char* const compiler = std::getenv("CC");
+    std::vector<std::string> command;
+    for (const auto word : std::string_view {compiler != nullptr ? compiler : "cc"} | std::views::split(' ')) {
+        if (!word.empty()) {
+            command.emplace_back(std::string_view {word});
+        }
+    }
+
+    if (command.empty()) {
+        command.emplace_back("cc");
+    }
+
+    command.insert(command.end(), {"-o", target, object, SKARN_RUNTIME_LIBRARY});
+    const llvm::ErrorOr<std::string> program = llvm::sys::findProgramByName(command.front());
+    if (!program) {
+        throw std::runtime_error {std::format("{}: cannot find the compiler", command.front())};
+    }
+
+    const std::vector<llvm::StringRef> args(command.begin(), command.end());
+    std::string error;
+    if (llvm::sys::ExecuteAndWait(*program, args, std::nullopt, {}, 0, 0, &error) != 0) {
+        throw std::runtime_error {std::format("linking failed: {}", error.empty() ? "the compiler returned an error" : error)};
+    }
+}
+
+void compile(const skarn::ast::Unit& unit, const Options& options) {
+    llvm::LLVMContext context;
+    const std::unique_ptr<llvm::Module> module = skarn::codegen::generate_ir(unit, context);
+    if (!skarn::codegen::add_entry_point(*module) && options.output == Output::Executable) {
+        throw std::runtime_error {"Function 'main' is not defined"};
+    }
+
+    const std::unique_ptr<llvm::TargetMachine> machine = skarn::codegen::create_target_machine(*module, options.level);
+    skarn::codegen::optimize(*module, options.level, machine.get());
+
+    switch (options.output) {
+        case Output::Ir:
+            write(options.target, [&module](llvm::raw_fd_ostream& out) {
+                module->print(out, nullptr);
+            });
+            break;
+        case Output::Assembly:
+        case Output::Object: {
+            const auto type = options.output == Output::Object ? skarn::codegen::FileType::Object : skarn::codegen::FileType::Assembly;
+            write(options.target, [&](llvm::raw_fd_ostream& out) {
+                skarn::codegen::emit(*module, *machine, out, type);
+            });
+            break;
+        }
+        case Output::Executable: {
+            const std::filesystem::path object = std::filesystem::temp_directory_path()
+                / std::format("skarnc-{:x}.o", std::random_device {}());
+            write(object.string(), [&](llvm::raw_fd_ostream& out) {
+                skarn::codegen::emit(*module, *machine, out, skarn::codegen::FileType::Object);
+            });
+
+            try {
+                link(object.string(), options.target);
+            }
+            catch (...) {
+                std::filesystem::remove(object);
+                throw;
+            }
+
+            std::filesystem::remove(object);
+            break;
+        }
+    }
+}
+
+} // namespace
+
+int main(const int argc, char* argv[])
+{
+    const std::optional<Options> options = parse_options(argc, argv);
+    if (!options) {
+        std::println(stderr, "Usage: skarnc [-O0 | -O1 | -O2 | -O3] [-c | -S | --emit-llvm] [-o <output file>] <source file>");
+        return 1;
+    }
+
+    const char* const path = options->source.c_str();
+    const std::optional<skarn::SourceFile> source = skarn::SourceFile::open(path);
+    if (!source) {
+        std::println(stderr, "{}: cannot open the file", path);
+        return 1;
+    }
+
+    skarn::ThreadPool pool;
+    auto unit = skarn::ast::parse_unit(source->text(), pool);
+    if (!unit) {
+        for (const skarn::parser::ParserMessage& message : unit.error()) {
+            std::println(stderr, "{}:{}:{}: error: expected {}", path, message.line, message.column, message.expected);
+        }
+
+        return 1;
+    }
+
+    try {
+        for (const std::string& warning : skarn::ast::analyze(*unit, pool)) {
+            std::println(stderr, "{}: warning: {}", path, warning);
+        }
+
+        compile(*unit, *options);
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::println(stderr, "{}: error: {}", path, e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,68 @@
+#include "Benchmark.h"
+#include <cstdlib>
+#include <format>
+#include <new>
+#include <print>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// The array and nothrow forms call these by default.
+void* operator new(const size_t size) {
+    skarn::bench::allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* const ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+
+    throw std::bad_alloc {};
+}
+
+void operator delete(void* const ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* const ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace skarn::bench {
+
+size_t peak_rss() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters {};
+    return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.PeakWorkingSetSize : 0;
+#else
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+std::string size_name(const size_t size) {
+    return size >= 1'000'000 ? std::format("{}MB", size / 1'000'000) : std::format("{}KB", size / 1'000);
+}
+
+Runner::Runner(Options options)
+    : options_ {std::move(options)} {
+    std::println("{:<40} {:>10} {:>10} {:>10} {:>10} {:>12}", "benchmark", "input KB", "iterations", "MB/s",
+        "allocs/KB", "peak RSS MB");
+}
+
+void Runner::report(const std::string_view name, const size_t bytes, const size_t iterations,
+    const std::chrono::nanoseconds time, const size_t allocations) const {
+    const double total = static_cast<double>(bytes) * static_cast<double>(iterations);
+    const double seconds = std::chrono::duration<double>(time).count();
+    std::println("{:<40} {:>10.1f} {:>10} {:>10.1f} {:>10.2f} {:>12.1f}", name, static_cast<double>(bytes) / 1e3,
+        iterations, total / seconds / 1e6, static_cast<double>(allocations) / (total / 1e3),
+        static_cast<double>(peak_rss()) / 1e6);
+}
+
+} // namespace skarn::bench
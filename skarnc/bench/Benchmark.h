@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace skarn::bench {
+
+/// Number of operator new calls in the process, counted by the replacement in Benchmark.cpp.
+inline std::atomic<size_t> allocation_count {0};
+
+/// The largest resident set size of the process so far, in bytes.
+size_t peak_rss();
+
+/// Size of a synthetic input in the benchmark names, e.g. 10KB or 1MB.
+std::string size_name(size_t size);
+
+struct Options {
+    std::string filter;                     // runs only the benchmarks whose name contains it
+    std::chrono::milliseconds min_time {500};
+    size_t max_size {100'000'000};          // of the synthetic units, in bytes
+};
+
+/// Runs a benchmark repeatedly for at least Options::min_time and prints a line with its throughput, allocations
+/// per KB of input and the peak RSS of the process after it. The first run is a warm-up unless it alone takes
+/// min_time, so large inputs are parsed once.
+class Runner final {
+    Options options_;
+
+    void report(std::string_view name, size_t bytes, size_t iterations, std::chrono::nanoseconds time,
+        size_t allocations) const;
+
+public:
+    explicit Runner(Options options);
+
+    [[nodiscard]] const Options& options() const noexcept {
+        return options_;
+    }
+
+    /// Runs body over an input of size bytes, body returns false if it failed on the input, e.g. did not parse it.
+    template <std::invocable Body>
+    void run(const std::string_view name, const size_t bytes, Body&& body) const {
+        using clock = std::chrono::steady_clock;
+
+        if (!name.contains(options_.filter)) {
+            return;
+        }
+
+        const auto once = [&] {
+            if (!body()) {
+                throw std::runtime_error(std::format("benchmark '{}' failed on its input", name));
+            }
+        };
+
+        size_t allocations = allocation_count.load(std::memory_order_relaxed);
+        auto start = clock::now();
+        once();
+        auto time = clock::now() - start;
+        size_t iterations = 1;
+        if (time < options_.min_time) {
+            allocations = allocation_count.load(std::memory_order_relaxed);
+            start = clock::now();
+            iterations = 0;
+            do {
+                once();
+                ++iterations;
+                time = clock::now() - start;
+            } while (time < options_.min_time);
+        }
+
+        report(name, bytes, iterations, time, allocation_count.load(std::memory_order_relaxed) - allocations);
+    }
+};
+
+void parser_benchmarks(const Runner& runner);
+void grammar_benchmarks(const Runner& runner);
+void pipeline_benchmarks(const Runner& runner);
+void engine_benchmarks(const Runner& runner);
+
+} // namespace skarn::bench
@@ -0,0 +1,81 @@
+#include "Benchmark.h"
+#include "ast/Parser.h"
+#include "ast/SlotResolver.h"
+#include "bytecode/Compiler.h"
+#include "bytecode/Vm.h"
+#include "interpreter/Interpreter.h"
+#include <cstdint>
+#include <format>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace skarn::bench {
+
+namespace {
+/// A hot loop of arithmetic on variables.
+constexpr std::string_view loopSource = R"(
+    fn fib(n) {
+        let a = 0;
+        let b = 1;
+        let i = 0;
+        while i < n {
+            let tmp = a;
+            a = b;
+            b = tmp + a;
+            i = i + 1;
+        }
+
+        a
+    }
+)";
+
+/// Calls and returns.
+constexpr std::string_view callSource = R"(
+    fn fib(n) {
+        while n < 2 {
+            return n;
+        }
+
+        fib(n - 1) + fib(n - 2)
+    }
+)";
+
+ast::Unit parse(const std::string_view source) {
+    auto unit = ast::parse_unit(source);
+    if (!unit) {
+        throw std::runtime_error {"the benchmark program does not parse"};
+    }
+
+    ast::resolve_slots(*unit);
+    return std::move(*unit);
+}
+
+/// Runs fib(argument) on the interpreter and on the VM, the input is the program.
+void run(const Runner& runner, const std::string_view name, const std::string_view source, const int64_t argument,
+    const int64_t expected) {
+    const ast::Unit unit = parse(source);
+    const bytecode::Program program = bytecode::compile(unit);
+    std::ostringstream out;
+    interpreter::Interpreter interpreter {unit, out};
+    bytecode::Vm vm {program, out};
+    const int64_t args[] {argument};
+
+    runner.run(std::format("engine/interpreter/{}", name), source.size(), [&] {
+        return interpreter.call("fib", args) == expected;
+    });
+
+    runner.run(std::format("engine/vm/{}", name), source.size(), [&] {
+        return vm.call("fib", args) == expected;
+    });
+}
+} // namespace
+
+/// The execution engines on the same programs, the throughput is relative to the size of the program.
+void engine_benchmarks(const Runner& runner) {
+    run(runner, "loop", loopSource, 40, 102334155);
+    run(runner, "calls", callSource, 20, 6765);
+}
+
+} // namespace skarn::bench
@@ -0,0 +1,159 @@
+#include "Benchmark.h"
+#include "ThreadPool.h"
+#include "ast/ParallelParser.h"
+#include <array>
+#include <format>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std::string_view_literals;
+
+namespace skarn::bench {
+
+namespace {
+/// Generates a unit of random functions covering the whole grammar, variables are declared before use and calls
+/// match the arity. The same size gives the same source.
+class SourceGenerator final {
+    static constexpr std::array binary_ops {"+"sv, "-"sv, "*"sv, "/"sv, "<"sv, "<="sv, ">"sv, ">="sv, "=="sv, "!="sv};
+
+    std::mt19937 random_ {20261018};
+    std::string source_;
+    std::vector<size_t> arities_; // of the generated functions
+    std::vector<std::string> variables_;
+
+    size_t pick(const size_t count) {
+        return std::uniform_int_distribution<size_t> {0, count - 1}(random_);
+    }
+
+    void indent(const size_t depth) {
+        source_.append(4 * depth, ' ');
+    }
+
+    void expression(const size_t depth) {
+        switch (depth == 0 ? pick(2) : pick(6)) {
+            case 0:
+                source_ += std::to_string(pick(1000));
+                break;
+            case 1:
+                source_ += variables_[pick(variables_.size())];
+                break;
+            case 2:
+                source_ += '(';
+                expression(depth - 1);
+                source_ += ')';
+                break;
+            case 3:
+                source_ += '-';
+                expression(depth - 1);
+                break;
+            case 4:
+                if (!arities_.empty()) {
+                    const size_t function = pick(arities_.size());
+                    std::format_to(std::back_inserter(source_), "f{}(", function);
+                    for (size_t i = 0; i < arities_[function]; ++i) {
+                        source_ += i == 0 ? "" : ", ";
+                        expression(depth - 1);
+                    }
+
+                    source_ += ')';
+                    break;
+                }
+
+                [[fallthrough]];
+            default:
+                expression(depth - 1);
+                std::format_to(std::back_inserter(source_), " {} ", binary_ops[pick(binary_ops.size())]);
+                expression(depth - 1);
+                break;
+        }
+    }
+
+    void statements(const size_t depth) {
+        const size_t count = 1 + pick(6);
+        for (size_t i = 0; i < count; ++i) {
+            indent(depth);
+            switch (depth > 2 ? pick(4) : pick(5)) {
+                case 0: {
+                    std::string name = std::format("v{}", variables_.size());
+                    std::format_to(std::back_inserter(source_), "let {} = ", name);
+                    expression(3);
+                    source_ += ";\n";
+                    variables_.push_back(std::move(name));
+                    break;
+                }
+                case 1:
+                    std::format_to(std::back_inserter(source_), "{} = ", variables_[pick(variables_.size())]);
+                    expression(3);
+                    source_ += ";\n";
+                    break;
+                case 2:
+                    source_ += "println(\"value: {}\", ";
+                    expression(2);
+                    source_ += ");\n";
+                    break;
+                case 3:
+                    source_ += "return ";
+                    expression(2);
+                    source_ += ";\n";
+                    break;
+                default: {
+                    source_ += "while ";
+                    expression(2);
+                    source_ += " {\n";
+                    const size_t scope = variables_.size();
+                    statements(depth + 1);
+                    variables_.resize(scope);
+                    indent(depth);
+                    source_ += "}\n";
+                    break;
+                }
+            }
+        }
+    }
+
+    void function() {
+        const size_t arity = 1 + pick(3);
+        variables_.clear();
+        std::format_to(std::back_inserter(source_), "fn f{}(", arities_.size());
+        for (size_t i = 0; i < arity; ++i) {
+            variables_.push_back(std::format("a{}", i));
+            std::format_to(std::back_inserter(source_), "{}{}", i == 0 ? "" : ", ", variables_.back());
+        }
+
+        source_ += ") {\n";
+        statements(1);
+        indent(1);
+        expression(3);
+        source_ += "\n}\n\n";
+        arities_.push_back(arity);
+    }
+
+public:
+    std::string generate(const size_t size) {
+        source_.reserve(size + 1024);
+        while (source_.size() < size) {
+            function();
+        }
+
+        return std::move(source_);
+    }
+};
+} // namespace
+
+void grammar_benchmarks(const Runner& runner) {
+    ThreadPool pool;
+    for (size_t size = 1'000; size <= runner.options().max_size; size *= 10) {
+        const std::string source = SourceGenerator {}.generate(size);
+        runner.run(std::format("grammar/sequential/{}", size_name(size)), source.size(), [&] {
+            return ast::parse_unit(source).has_value();
+        });
+
+        runner.run(std::format("grammar/parallel/{}", size_name(size)), source.size(), [&] {
+            return ast::parse_unit(source, pool).has_value();
+        });
+    }
+}
+
+} // namespace skarn::bench
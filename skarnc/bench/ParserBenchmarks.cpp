@@ -0,0 +1,119 @@
+#include "Benchmark.h"
+#include "parser/Parser.h"
+#include <string>
+#include <type_traits>
+
+using namespace std::string_view_literals;
+using namespace skarn::parser;
+
+namespace skarn::bench {
+
+namespace {
+constexpr size_t input_size = 64 << 10;
+
+std::string repeat(const std::string_view token) {
+    std::string input;
+    input.reserve(input_size + token.size());
+    while (input.size() < input_size) {
+        input += token;
+    }
+
+    return input;
+}
+
+/// Parses tokens until the end of the input, each followed by skip separator characters.
+template <class Parser>
+bool parse_tokens(const Parser& parser, const std::string_view input, const size_t skip = 0, const bool packrat = false) {
+    ParserContext<char> ctx {input};
+    ctx.packrat(packrat);
+    while (!ctx.input().empty()) {
+        if constexpr (std::is_same_v<typename Parser::ValueType, NoValueType>) {
+            if (!parser.parse(ctx)) {
+                return false;
+            }
+        }
+        else {
+            typename Parser::ValueType value {};
+            if (!parser.parse(ctx, value)) {
+                return false;
+            }
+        }
+
+        ctx.consume(skip);
+    }
+
+    return true;
+}
+
+struct ReferenceTag;
+struct PackratReferenceTag;
+struct NestedReferenceTag;
+
+/// The same recursive grammar of bracketed integers, bound by RuleParser and by ReferenceParser.
+struct NestedRule;
+
+constexpr auto nestedRule = Parse::rule<NestedRule, int>();
+constexpr auto nestedByRule = (~Parse::char_('(') >> nestedRule >> ~Parse::char_(')')) || Parse::integer<int>();
+
+struct NestedRule {
+    static constexpr auto definition = nestedByRule;
+};
+
+constexpr ParserInterface<ReferenceParser<int, char, NestedReferenceTag>> nestedReference {};
+constexpr auto nestedByReference = (~Parse::char_('(') >> nestedReference >> ~Parse::char_(')')) || Parse::integer<int>();
+} // namespace
+
+void parser_benchmarks(const Runner& runner) {
+    const std::string chars = repeat("x"sv);
+    runner.run("CharParser", chars.size(), [&] {
+        return parse_tokens(Parse::char_('x').parser(), chars);
+    });
+
+    const std::string literals = repeat("value"sv);
+    runner.run("LiteralParser", literals.size(), [&] {
+        return parse_tokens(Parse::literal("value"sv).parser(), literals);
+    });
+
+    const std::string integers = repeat("-1234567,"sv);
+    runner.run("IntParser", integers.size(), [&] {
+        return parse_tokens(Parse::integer<int>().parser(), integers, 1);
+    });
+
+    runner.run("SequenceParser/char", chars.size(), [&] {
+        return parse_tokens((*Parse::char_('x')).parser(), chars);
+    });
+
+    const std::string spaces = repeat(" \t\n"sv);
+    runner.run("SequenceParser/ignored whitespace", spaces.size(), [&] {
+        return parse_tokens((*~Parse::ws()).parser(), spaces);
+    });
+
+    const std::string variants = repeat("1234567,value,"sv);
+    runner.run("VariantParser", variants.size(), [&] {
+        return parse_tokens((Parse::integer<int>() || Parse::literal("value"sv)).parser(), variants, 1);
+    });
+
+    constexpr ParserInterface<ReferenceParser<int, char, ReferenceTag>> reference {};
+    reference.assign(Parse::integer<int>());
+    runner.run("ReferenceParser", integers.size(), [&] {
+        return parse_tokens(reference.parser(), integers, 1);
+    });
+
+    constexpr ParserInterface<ReferenceParser<int, char, PackratReferenceTag>> packrat_reference {};
+    packrat_reference.assign(Parse::integer<int>());
+    runner.run("ReferenceParser/packrat", integers.size(), [&] {
+        return parse_tokens(packrat_reference.parser(), integers, 1, true);
+    });
+
+    const std::string nested = repeat("((((((((1234567)))))))),"sv);
+    nestedReference.assign(nestedByReference);
+    runner.run("ReferenceParser/recursive", nested.size(), [&] {
+        return parse_tokens(nestedReference.parser(), nested, 1);
+    });
+
+    runner.run("RuleParser/recursive", nested.size(), [&] {
+        return parse_tokens(nestedRule.parser(), nested, 1);
+    });
+}
+
+} // namespace skarn::bench
@@ -0,0 +1,71 @@
+#include "Benchmark.h"
+#include "ThreadPool.h"
+#include "ast/Analysis.h"
+#include "ast/ParallelParser.h"
+#include "bytecode/Compiler.h"
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <string>
+#include <tuple>
+
+namespace skarn::bench {
+
+namespace {
+/// The analysis keeps the whole unit and its bytecode in memory, larger units only measure the allocator.
+constexpr size_t max_pipeline_size = 10'000'000;
+
+/// Functions calling the previous one, each shadows a variable, so every pass of the front end has work to do.
+std::string synthetic_source(const size_t size) {
+    std::string source;
+    source.reserve(size + 1024);
+    for (size_t i = 0; source.size() < size; ++i) {
+        std::format_to(std::back_inserter(source), R"(
+            fn f{0}(n) {{
+                let a = n * {0} + 2 * 3;
+                let i = 0;
+                while i < n {{
+                    let a = a + 1 + 1;
+                    i = i + a - a + 1;
+                }}
+
+                println("f{0}: {{}}", a);
+                {1}
+            }}
+        )", i, i == 0 ? std::string {"a"} : std::format("a + f{}(n - 1)", i - 1));
+    }
+
+    return source;
+}
+} // namespace
+
+/// The front end and the bytecode compilation of a unit, from the source to the program.
+void pipeline_benchmarks(const Runner& runner) {
+    ThreadPool pool;
+    for (size_t size = 1'000; size <= std::min(runner.options().max_size, max_pipeline_size); size *= 10) {
+        const std::string source = synthetic_source(size);
+        runner.run(std::format("pipeline/sequential/{}", size_name(size)), source.size(), [&] {
+            auto unit = ast::parse_unit(source);
+            if (!unit) {
+                return false;
+            }
+
+            ast::resolve_slots(*unit);
+            ast::infer_types(*unit);
+            ast::fold_constants(*unit);
+            return !bytecode::compile(*unit).functions.empty();
+        });
+
+        runner.run(std::format("pipeline/parallel/{}", size_name(size)), source.size(), [&] {
+            auto unit = ast::parse_unit(source, pool);
+            if (!unit) {
+                return false;
+            }
+
+            std::ignore = ast::analyze(*unit, pool);
+            return !bytecode::compile(*unit, pool).functions.empty();
+        });
+    }
+}
+
+} // namespace skarn::bench
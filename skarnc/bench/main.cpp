@@ -0,0 +1,48 @@
+#include "Benchmark.h"
+#include <charconv>
+#include <exception>
+#include <print>
+#include <string_view>
+
+namespace {
+bool parse_size(const std::string_view text, size_t& value) {
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc {} && end == text.data() + text.size();
+}
+} // namespace
+
+int main(const int argc, char* argv[])
+{
+    skarn::bench::Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        size_t value = 0;
+        if (arg.starts_with("--filter=")) {
+            options.filter = arg.substr(9);
+        }
+        else if (arg.starts_with("--min-time=") && parse_size(arg.substr(11), value)) {
+            options.min_time = std::chrono::milliseconds {value};
+        }
+        else if (arg.starts_with("--max-size=") && parse_size(arg.substr(11), value)) {
+            options.max_size = value;
+        }
+        else {
+            std::println(stderr, "Usage: skarnc-bench [--filter=<name part>] [--min-time=<ms>] [--max-size=<bytes>]");
+            return 1;
+        }
+    }
+
+    try {
+        const skarn::bench::Runner runner {std::move(options)};
+        skarn::bench::parser_benchmarks(runner);
+        skarn::bench::grammar_benchmarks(runner);
+        skarn::bench::pipeline_benchmarks(runner);
+        skarn::bench::engine_benchmarks(runner);
+    }
+    catch (const std::exception& e) {
+        std::println(stderr, "error: {}", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace skarn {
+
+/// Bump allocator, memory is released all at once when the arena is destroyed.
+/// Objects are never destroyed, so only trivially destructible types can be created.
+class Arena final {
+public:
+    static constexpr size_t default_block_size = 64 * 1024;
+
+private:
+    std::vector<std::unique_ptr<std::byte[]>> blocks_;
+    std::byte* current_ {};
+    size_t remaining_ {};
+    size_t block_size_ {default_block_size};
+    size_t allocated_ {};
+
+    void addBlock(const size_t min_size) {
+        const size_t size = std::max(block_size_, min_size);
+        blocks_.push_back(std::make_unique_for_overwrite<std::byte[]>(size));
+        current_ = blocks_.back().get();
+        remaining_ = size;
+    }
+
+public:
+    Arena() noexcept = default;
+
+    explicit Arena(const size_t block_size) noexcept
+        : block_size_ {block_size} {
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator =(const Arena&) = delete;
+
+    /// The other arena is left empty, a later allocation from it starts a block of its own.
+    Arena(Arena&& other) noexcept
+        : blocks_ {std::move(other.blocks_)}
+        , current_ {std::exchange(other.current_, nullptr)}
+        , remaining_ {std::exchange(other.remaining_, 0)}
+        , block_size_ {other.block_size_}
+        , allocated_ {std::exchange(other.allocated_, 0)} {
+        other.blocks_.clear();
+    }
+
+    Arena& operator =(Arena&& other) noexcept {
+        if (this != &other) {
+            blocks_ = std::move(other.blocks_);
+            current_ = std::exchange(other.current_, nullptr);
+            remaining_ = std::exchange(other.remaining_, 0);
+            block_size_ = other.block_size_;
+            allocated_ = std::exchange(other.allocated_, 0);
+            other.blocks_.clear();
+        }
+
+        return *this;
+    }
+
+    [[nodiscard]] void* allocate(const size_t size, const size_t alignment = alignof(std::max_align_t)) {
+        size_t padding = -reinterpret_cast<uintptr_t>(current_) & (alignment - 1);
+        if (padding + size > remaining_) {
+            addBlock(size + alignment);
+            padding = -reinterpret_cast<uintptr_t>(current_) & (alignment - 1);
+        }
+
+        std::byte* const result = current_ + padding;
+        current_ = result + size;
+        remaining_ -= padding + size;
+        allocated_ += size;
+        return result;
+    }
+
+    template <class T, class...Args>
+    requires (std::is_trivially_destructible_v<T>)
+    [[nodiscard]] T* create(Args&&...args) {
+        return std::construct_at(static_cast<T*>(allocate(sizeof(T), alignof(T))), std::forward<Args>(args)...);
+    }
+
+    /// Copies the elements into the arena, the result stays valid for the lifetime of the arena.
+    template <std::ranges::contiguous_range Range, class T = std::ranges::range_value_t<Range>>
+    requires (std::is_trivially_copyable_v<T>)
+    [[nodiscard]] std::span<T> copy_array(const Range& values) {
+        const size_t size = std::ranges::size(values);
+        if (size == 0) {
+            return {};
+        }
+
+        T* const data = static_cast<T*>(allocate(sizeof(T) * size, alignof(T)));
+        std::ranges::uninitialized_copy(values, std::span<T> {data, size});
+        return std::span<T> {data, size};
+    }
+
+    /// Copies the string into the arena, the result stays valid for the lifetime of the arena.
+    [[nodiscard]] std::string_view copy(const std::string_view str) {
+        if (str.empty()) {
+            return {};
+        }
+
+        char* const data = static_cast<char*>(allocate(str.size(), 1));
+        std::memcpy(data, str.data(), str.size());
+        return std::string_view {data, str.size()};
+    }
+
+    /// Takes over the memory of the other arena, e.g. of a worker thread, which is left empty.
+    /// Its allocations stay valid for the lifetime of this arena.
+    void merge(Arena&& other) {
+        blocks_.insert(blocks_.end(), std::make_move_iterator(other.blocks_.begin()), std::make_move_iterator(other.blocks_.end()));
+        allocated_ += other.allocated_;
+        other.blocks_.clear();
+        other.current_ = nullptr;
+        other.remaining_ = 0;
+        other.allocated_ = 0;
+    }
+
+    /// Number of bytes handed out, excluding padding.
+    [[nodiscard]] size_t allocated() const noexcept {
+        return allocated_;
+    }
+
+    [[nodiscard]] size_t block_count() const noexcept {
+        return blocks_.size();
+    }
+};
+
+} // namespace skarn
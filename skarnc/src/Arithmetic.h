@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace skarn {
+
+// Arithmetic on the values of the language, shared by the execution engines. Results wrap around in two's complement,
+// like the instructions emitted by the LLVM backend: the operations are done in uint64_t, which defines overflow.
+
+[[nodiscard]] constexpr int64_t wrapping_negate(const int64_t value) noexcept {
+    return static_cast<int64_t>(0 - static_cast<uint64_t>(value));
+}
+
+[[nodiscard]] constexpr int64_t wrapping_add(const int64_t lhs, const int64_t rhs) noexcept {
+    return static_cast<int64_t>(static_cast<uint64_t>(lhs) + static_cast<uint64_t>(rhs));
+}
+
+[[nodiscard]] constexpr int64_t wrapping_subtract(const int64_t lhs, const int64_t rhs) noexcept {
+    return static_cast<int64_t>(static_cast<uint64_t>(lhs) - static_cast<uint64_t>(rhs));
+}
+
+[[nodiscard]] constexpr int64_t wrapping_multiply(const int64_t lhs, const int64_t rhs) noexcept {
+    return static_cast<int64_t>(static_cast<uint64_t>(lhs) * static_cast<uint64_t>(rhs));
+}
+
+/// Truncating division, INT64_MIN / -1 wraps to INT64_MIN like the negation.
+[[nodiscard]] constexpr int64_t wrapping_divide(const int64_t lhs, const int64_t rhs) {
+    if (rhs == 0) {
+        throw std::runtime_error {"Division by zero"};
+    }
+
+    return rhs == -1 ? wrapping_negate(lhs) : lhs / rhs;
+}
+
+} // namespace skarn
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+namespace skarn {
+
+/// Call depth shared by the execution engines, so a program overflows the stack at the same depth in each of them.
+/// The interpreter recurses on the native stack, so the depth is derived from the native stack it may use.
+struct CallLimits {
+    /// Upper estimate of the native stack one interpreted call takes, with the evaluation of its body.
+    static constexpr size_t native_frame_size = 4096;
+
+#ifdef _WIN32
+    static constexpr size_t default_native_stack_size = 1024 * 1024; // the default stack of the main thread
+#else
+    static constexpr size_t default_native_stack_size = 8 * 1024 * 1024;
+#endif
+
+    size_t native_stack_size {default_native_stack_size};
+
+    /// The number of calls that may be active at once, including the outermost one.
+    [[nodiscard]] constexpr size_t max_depth() const noexcept {
+        return native_stack_size / native_frame_size;
+    }
+};
+
+} // namespace skarn
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace skarn {
+
+/// Text of a source file. Regular files are memory-mapped for sequential reading, so the parser reads the pages
+/// directly, other files, e.g. pipes, are read into memory. The path "-" stands for the standard input.
+class SourceFile final {
+    static constexpr size_t read_chunk_size = 64 << 10;
+
+    std::string buffer_; // the text of a file that is not mapped
+    const char* mapped_data_ {};
+    size_t mapped_size_ {};
+
+    SourceFile() = default;
+
+#ifdef _WIN32
+    bool map(const HANDLE file) {
+        LARGE_INTEGER size {};
+        if (GetFileType(file) != FILE_TYPE_DISK || !GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            return false;
+        }
+
+        const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            return false;
+        }
+
+        const void* const data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping); // the view keeps the mapping
+        if (data == nullptr) {
+            return false;
+        }
+
+        mapped_data_ = static_cast<const char*>(data);
+        mapped_size_ = static_cast<size_t>(size.QuadPart);
+        return true;
+    }
+
+    bool read(const HANDLE file) {
+        for (;;) {
+            const size_t size = buffer_.size();
+            buffer_.resize(size + read_chunk_size);
+            DWORD count = 0;
+            const BOOL result = ReadFile(file, buffer_.data() + size, static_cast<DWORD>(read_chunk_size), &count, nullptr);
+            buffer_.resize(size + count);
+            if (!result) {
+                return GetLastError() == ERROR_BROKEN_PIPE; // the writing end of a pipe is closed
+            }
+
+            if (count == 0) {
+                return true;
+            }
+        }
+    }
+
+    void unmap() noexcept {
+        if (mapped_data_ != nullptr) {
+            UnmapViewOfFile(mapped_data_);
+        }
+    }
+#else
+    bool map(const int fd) {
+        struct stat info {};
+        if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+            return false;
+        }
+
+        const auto size = static_cast<size_t>(info.st_size);
+        void* const data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+
+        std::ignore = madvise(data, size, MADV_SEQUENTIAL);
+        mapped_data_ = static_cast<const char*>(data);
+        mapped_size_ = size;
+        return true;
+    }
+
+    bool read(const int fd) {
+        for (;;) {
+            const size_t size = buffer_.size();
+            buffer_.resize(size + read_chunk_size);
+            const ssize_t count = ::read(fd, buffer_.data() + size, read_chunk_size);
+            buffer_.resize(size + static_cast<size_t>(std::max<ssize_t>(count, 0)));
+            if (count < 0 && errno != EINTR) {
+                return false;
+            }
+
+            if (count == 0) {
+                return true;
+            }
+        }
+    }
+
+    void unmap() noexcept {
+        if (mapped_data_ != nullptr) {
+            munmap(const_cast<char*>(mapped_data_), mapped_size_);
+        }
+    }
+#endif
+
+public:
+    SourceFile(SourceFile&& other) noexcept
+        : buffer_ {std::move(other.buffer_)}
+        , mapped_data_ {std::exchange(other.mapped_data_, nullptr)}
+        , mapped_size_ {std::exchange(other.mapped_size_, 0)} {
+    }
+
+    SourceFile& operator=(SourceFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            buffer_ = std::move(other.buffer_);
+            mapped_data_ = std::exchange(other.mapped_data_, nullptr);
+            mapped_size_ = std::exchange(other.mapped_size_, 0);
+        }
+
+        return *this;
+    }
+
+    ~SourceFile() {
+        unmap();
+    }
+
+    /// Maps or reads the file, nothing is returned if the file cannot be opened or read.
+    [[nodiscard]] static std::optional<SourceFile> open(const std::filesystem::path& path) {
+        SourceFile source;
+        const bool standard_input = path == "-";
+#ifdef _WIN32
+        const HANDLE file = standard_input
+            ? GetStdHandle(STD_INPUT_HANDLE)
+            : CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE || file == nullptr) {
+            return std::nullopt;
+        }
+
+        const bool result = source.map(file) || source.read(file);
+        if (!standard_input) {
+            CloseHandle(file);
+        }
+#else
+        const int fd = standard_input ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return std::nullopt;
+        }
+
+        const bool result = source.map(fd) || source.read(fd);
+        if (!standard_input) {
+            close(fd); // the mapping stays valid
+        }
+#endif
+
+        if (!result) {
+            return std::nullopt;
+        }
+
+        return source;
+    }
+
+    [[nodiscard]] bool mapped() const noexcept {
+        return mapped_data_ != nullptr;
+    }
+
+    [[nodiscard]] std::string_view text() const noexcept {
+        return mapped() ? std::string_view {mapped_data_, mapped_size_} : std::string_view {buffer_};
+    }
+};
+
+} // namespace skarn
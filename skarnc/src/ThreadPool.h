@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace skarn {
+
+/// Work-stealing pool for loops over independent tasks, e.g. the functions of a unit.
+/// parallel_for splits the indices into a range per worker, a worker takes the tasks from the front of its range
+/// and, when it runs out, steals the back half of another range. Threads are started by the first parallel loop.
+class ThreadPool final {
+public:
+    /// Fewer tasks run on the calling thread, waking the workers would cost more than the tasks.
+    static constexpr size_t min_parallel_count = 64;
+
+private:
+    struct alignas(64) Range {
+        std::mutex mutex;
+        size_t begin {};
+        size_t end {};
+    };
+
+    struct Job {
+        void (*run)(const void* body, size_t index, size_t worker);
+        const void* body;
+    };
+
+    size_t thread_count_;
+    std::unique_ptr<Range[]> ranges_;
+    std::mutex mutex_;
+    std::condition_variable_any wake_;
+    std::condition_variable done_;
+    Job job_ {};
+    uint64_t generation_ {};
+    size_t finished_ {}; // workers done with the current job
+    size_t error_index_ {};
+    std::exception_ptr error_;
+    std::vector<std::jthread> threads_; // the last member, the threads are stopped and joined first
+
+    [[nodiscard]] std::optional<size_t> next(const size_t worker) {
+        Range& own = ranges_[worker];
+        {
+            const std::lock_guard lock {own.mutex};
+            if (own.begin != own.end) {
+                return own.begin++;
+            }
+        }
+
+        for (size_t i = 1; i < thread_count_; ++i) {
+            Range& victim = ranges_[(worker + i) % thread_count_];
+            size_t begin;
+            size_t end;
+            {
+                const std::lock_guard lock {victim.mutex};
+                if (victim.begin == victim.end) {
+                    continue;
+                }
+
+                begin = victim.begin + (victim.end - victim.begin) / 2;
+                end = victim.end;
+                victim.end = begin;
+            }
+
+            const std::lock_guard lock {own.mutex};
+            own.begin = begin + 1;
+            own.end = end;
+            return begin;
+        }
+
+        return std::nullopt;
+    }
+
+    /// Keeps the exception of the first failed task, so the error does not depend on the scheduling.
+    void fail(const size_t index) {
+        const std::lock_guard lock {mutex_};
+        if (!error_ || index < error_index_) {
+            error_ = std::current_exception();
+            error_index_ = index;
+        }
+    }
+
+    void work(const std::stop_token& stop, const size_t worker) {
+        uint64_t generation = 0;
+        while (true) {
+            Job job;
+            {
+                std::unique_lock lock {mutex_};
+                if (!wake_.wait(lock, stop, [this, generation] { return generation_ != generation; })) {
+                    return;
+                }
+
+                generation = generation_;
+                job = job_;
+            }
+
+            while (const std::optional<size_t> index = next(worker)) {
+                try {
+                    job.run(job.body, *index, worker);
+                }
+                catch (...) {
+                    fail(*index);
+                }
+            }
+
+            const std::lock_guard lock {mutex_};
+            if (++finished_ == thread_count_) {
+                done_.notify_one();
+            }
+        }
+    }
+
+public:
+    explicit ThreadPool(const size_t thread_count = std::thread::hardware_concurrency())
+        : thread_count_ {std::max<size_t>(thread_count, 1)}
+        , ranges_ {std::make_unique<Range[]>(thread_count_)} {
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator =(const ThreadPool&) = delete;
+
+    /// Number of the workers, the worker index passed to the tasks is below it.
+    [[nodiscard]] size_t thread_count() const noexcept {
+        return thread_count_;
+    }
+
+    /// Calls body(index, worker) for every index below count and waits for all of them. Tasks of one worker never
+    /// run concurrently, so they can share per-worker state. If tasks throw, the exception of the lowest index is
+    /// rethrown once all tasks are finished.
+    template <class Body>
+    void parallel_for(const size_t count, const Body& body) {
+        if (thread_count_ == 1 || count < min_parallel_count) {
+            for (size_t index = 0; index < count; ++index) {
+                body(index, size_t {0});
+            }
+
+            return;
+        }
+
+        if (threads_.empty()) {
+            threads_.reserve(thread_count_);
+            for (size_t worker = 0; worker < thread_count_; ++worker) {
+                threads_.emplace_back([this, worker](const std::stop_token& stop) { work(stop, worker); });
+            }
+        }
+
+        for (size_t worker = 0; worker < thread_count_; ++worker) {
+            const std::lock_guard lock {ranges_[worker].mutex};
+            ranges_[worker].begin = count * worker / thread_count_;
+            ranges_[worker].end = count * (worker + 1) / thread_count_;
+        }
+
+        std::unique_lock lock {mutex_};
+        job_ = Job {
+            .run = [](const void* job_body, const size_t index, const size_t worker) {
+                (*static_cast<const Body*>(job_body))(index, worker);
+            },
+            .body = &body,
+        };
+        finished_ = 0;
+        error_ = nullptr;
+        ++generation_;
+        wake_.notify_all();
+        done_.wait(lock, [this] { return finished_ == thread_count_; });
+
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+};
+
+} // namespace skarn
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "ConstantFolder.h"
+#include "SlotResolver.h"
+#include "ThreadPool.h"
+#include "TypeInference.h"
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace skarn::ast {
+
+/// Runs the passes of the front end: resolve_slots, infer_types and fold_constants.
+/// Resolution and folding look at one function at a time, so the functions are distributed over the pool,
+/// types are inferred over the whole unit in between, as calls unify the types of functions.
+/// The result does not depend on the scheduling: the warnings are in the order of the functions and
+/// the error of the first function that fails is thrown. Returns the warnings.
+inline std::vector<std::string> analyze(Unit& unit, ThreadPool& pool) {
+    const size_t count = unit.functions.size();
+    std::vector<std::vector<std::string>> warnings(count);
+    const SlotResolver resolver {unit};
+    std::vector<std::optional<SlotResolver>> resolvers(pool.thread_count());
+    pool.parallel_for(count, [&](const size_t index, const size_t worker) {
+        std::optional<SlotResolver>& local = resolvers[worker];
+        if (!local) {
+            local.emplace(resolver);
+        }
+
+        local->resolve(unit.functions[index]);
+        warnings[index] = local->take_warnings();
+    });
+
+    infer_types(unit);
+
+    std::vector<Arena> arenas(pool.thread_count()); // the folder allocates new nodes, the unit arena is not shared
+    pool.parallel_for(count, [&](const size_t index, const size_t worker) {
+        ConstantFolder {arenas[worker]}.fold(unit.functions[index]);
+    });
+
+    for (Arena& arena : arenas) {
+        unit.arena.merge(std::move(arena));
+    }
+
+    std::vector<std::string> result;
+    for (std::vector<std::string>& function_warnings : warnings) {
+        std::ranges::move(function_warnings, std::back_inserter(result));
+    }
+
+    return result;
+}
+
+} // namespace skarn::ast
@@ -0,0 +1,312 @@
+#pragma once
+
+#include "Unit.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace skarn::ast {
+
+/// Folds constants and simplifies the expressions of a unit in place:
+/// - operators on constants are computed, unless the result does not fit a constant or divides by zero,
+///   which is left to fail at run time;
+/// - chains of one operator become a single node: a nested first operand is merged as the chain is a left fold,
+///   any nested operand of + and * is merged as they are associative;
+/// - the constants of + and * chains and the subtracted constants are merged into one, which is dropped if it is
+///   0 or 1, x / 1 and double negation are removed, x * 0 becomes 0 if x has no side effects.
+/// Replaced nodes keep their type. Comparisons are folded only after infer_types, so that the types stay valid.
+/// New child arrays are allocated in the arena of the unit.
+class ConstantFolder final {
+    Arena& arena_;
+    size_t eliminated_ {};
+
+    [[nodiscard]] static std::optional<int> fit(const int64_t value) noexcept {
+        if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+            return std::nullopt;
+        }
+
+        return static_cast<int>(value);
+    }
+
+    [[nodiscard]] static const int* constant(const Expression& expression) noexcept {
+        const auto* expr = std::get_if<ConstantExpression>(&expression.value);
+        return expr != nullptr ? &expr->value : nullptr;
+    }
+
+    [[nodiscard]] static Expression constant(const int value, const TypeInfo type) noexcept {
+        Expression result = Expression::constant(value);
+        result.type = type;
+        return result;
+    }
+
+    /// Evaluating the expression only computes its value: there are no calls and no divisions, which may fail.
+    [[nodiscard]] static bool pure(const Expression& expression) noexcept {
+        return std::visit([]<class T>(const T& expr) {
+            if constexpr (std::is_same_v<T, UnaryExpression>) {
+                return pure(*expr.arg);
+            }
+            else if constexpr (std::is_same_v<T, BinaryExpression>) {
+                return expr.op != BinaryOp::Divide && std::ranges::all_of(expr.args, &ConstantFolder::pure);
+            }
+            else {
+                return !std::is_same_v<T, FunctionCallExpression>;
+            }
+        }, expression.value);
+    }
+
+    [[nodiscard]] static size_t count(const Expression& expression) noexcept {
+        return std::visit([]<class T>(const T& expr) -> size_t {
+            if constexpr (std::is_same_v<T, UnaryExpression>) {
+                return 1 + count(*expr.arg);
+            }
+            else if constexpr (OneOf<T, BinaryExpression, FunctionCallExpression>) {
+                size_t result = 1;
+                for (const Expression& arg : expr.args) {
+                    result += count(arg);
+                }
+
+                return result;
+            }
+            else {
+                return 1;
+            }
+        }, expression.value);
+    }
+
+    [[nodiscard]] static std::optional<int64_t> apply(const BinaryOp op, const int64_t lhs, const int64_t rhs) noexcept {
+        switch (op) {
+            case BinaryOp::Add:
+                return lhs + rhs;
+            case BinaryOp::Subtract:
+                return lhs - rhs;
+            case BinaryOp::Multiply:
+                return lhs * rhs;
+            case BinaryOp::Divide:
+                return rhs != 0 ? std::optional {lhs / rhs} : std::nullopt;
+            case BinaryOp::Equal:
+                return lhs == rhs;
+            case BinaryOp::NotEqual:
+                return lhs != rhs;
+            case BinaryOp::LessThan:
+                return lhs < rhs;
+            case BinaryOp::LessThanOrEqual:
+                return lhs <= rhs;
+            case BinaryOp::GreaterThan:
+                return lhs > rhs;
+            case BinaryOp::GreaterThanOrEqual:
+                return lhs >= rhs;
+        }
+
+        return std::nullopt;
+    }
+
+    [[nodiscard]] static bool associative(const BinaryOp op) noexcept {
+        return op == BinaryOp::Add || op == BinaryOp::Multiply;
+    }
+
+    [[nodiscard]] static bool comparison(const BinaryOp op) noexcept {
+        return !associative(op) && op != BinaryOp::Subtract && op != BinaryOp::Divide;
+    }
+
+    /// Replaces the node by the expression, the type of the node is kept.
+    static void replace(Expression& target, Expression source) noexcept {
+        source.type = target.type;
+        target = source;
+    }
+
+    /// Merges the constant operands of + and *, the operands are computed in any order.
+    /// The merged constant takes the place of the first one.
+    static void mergeConstants(const BinaryOp op, std::vector<Expression>& operands, const TypeInfo type) {
+        const int64_t identity = op == BinaryOp::Add ? 0 : 1;
+        int64_t merged = identity;
+        std::optional<size_t> position;
+        std::vector<Expression> rest;
+        for (const Expression& operand : operands) {
+            const int* value = constant(operand);
+            const std::optional<int64_t> next = value != nullptr ? apply(op, merged, *value) : std::nullopt;
+            if (next && fit(*next)) {
+                merged = *next;
+                position = position.value_or(rest.size());
+            }
+            else {
+                rest.push_back(operand);
+            }
+        }
+
+        if (op == BinaryOp::Multiply && merged == 0 && std::ranges::all_of(rest, &ConstantFolder::pure)) {
+            rest.clear();
+            position = 0;
+        }
+
+        if (merged != identity || rest.empty()) {
+            rest.insert(rest.begin() + static_cast<ptrdiff_t>(position.value_or(0)), constant(static_cast<int>(merged), type));
+        }
+
+        operands = std::move(rest);
+    }
+
+    /// Merges the constant subtrahends, a - 2 - b - 3 is a - 5 - b, and the minuend if it is a constant.
+    static void mergeSubtrahends(std::vector<Expression>& operands, const TypeInfo type) {
+        int64_t merged = 0;
+        std::optional<size_t> position;
+        std::vector<Expression> rest {operands[0]};
+        for (size_t i = 1; i < operands.size(); ++i) {
+            const int* value = constant(operands[i]);
+            if (value != nullptr && fit(merged + *value)) {
+                merged += *value;
+                position = position.value_or(rest.size());
+            }
+            else {
+                rest.push_back(operands[i]);
+            }
+        }
+
+        if (const int* minuend = constant(rest[0]); minuend != nullptr && fit(*minuend - merged)) {
+            rest[0] = constant(static_cast<int>(*minuend - merged), type);
+        }
+        else if (merged != 0) {
+            rest.insert(rest.begin() + static_cast<ptrdiff_t>(*position), constant(static_cast<int>(merged), type));
+        }
+
+        operands = std::move(rest);
+    }
+
+    /// Computes the leading constants of a chain, e.g. 8 / 2 / x is 4 / x, and drops the trailing divisions by 1.
+    static void foldPrefix(const BinaryOp op, std::vector<Expression>& operands, const TypeInfo type) {
+        while (operands.size() > 1) {
+            const int* lhs = constant(operands[0]);
+            const int* rhs = constant(operands[1]);
+            const std::optional<int64_t> value = lhs != nullptr && rhs != nullptr ? apply(op, *lhs, *rhs) : std::nullopt;
+            const std::optional<int> result = value ? fit(*value) : std::nullopt;
+            if (!result) {
+                break;
+            }
+
+            operands.erase(operands.begin());
+            operands[0] = constant(*result, type);
+        }
+
+        if (op == BinaryOp::Divide) {
+            std::erase_if(operands, [&operands](const Expression& operand) {
+                const int* value = constant(operand);
+                return &operand != &operands[0] && value != nullptr && *value == 1;
+            });
+        }
+    }
+
+    void fold(BinaryExpression& expr, Expression& expression) {
+        std::vector<Expression> operands;
+        bool flattened = false;
+        for (size_t i = 0; i < expr.args.size(); ++i) {
+            fold(expr.args[i]);
+            const auto* nested = std::get_if<BinaryExpression>(&expr.args[i].value);
+            if (nested != nullptr && nested->op == expr.op && (i == 0 || associative(expr.op))) {
+                operands.insert(operands.end(), nested->args.begin(), nested->args.end());
+                flattened = true;
+            }
+            else {
+                operands.push_back(expr.args[i]);
+            }
+        }
+
+        if (associative(expr.op)) {
+            mergeConstants(expr.op, operands, expression.type);
+        }
+        else if (expr.op == BinaryOp::Subtract) {
+            mergeSubtrahends(operands, expression.type);
+        }
+        else if (!comparison(expr.op) || expression.type.kind == TypeKind::Bool) {
+            foldPrefix(expr.op, operands, expression.type);
+        }
+
+        if (operands.size() == 1) {
+            replace(expression, operands[0]);
+        }
+        else if (flattened || operands.size() != expr.args.size()) { // otherwise the operands are the same
+            expr.args = arena_.copy_array(operands);
+        }
+    }
+
+    void fold(Expression& expression) {
+        std::visit([this, &expression]<class T>(T& expr) {
+            if constexpr (std::is_same_v<T, UnaryExpression>) {
+                fold(*expr.arg);
+                if (expr.op == UnaryOp::Plus) {
+                    replace(expression, *expr.arg);
+                }
+                else if (const int* value = constant(*expr.arg); value != nullptr && fit(-int64_t {*value})) {
+                    replace(expression, Expression::constant(-*value));
+                }
+                else if (const auto* nested = std::get_if<UnaryExpression>(&expr.arg->value); nested != nullptr && nested->op == UnaryOp::Minus) {
+                    replace(expression, *nested->arg);
+                }
+            }
+            else if constexpr (std::is_same_v<T, BinaryExpression>) {
+                fold(expr, expression);
+            }
+            else if constexpr (std::is_same_v<T, FunctionCallExpression>) {
+                for (Expression& arg : expr.args) {
+                    fold(arg);
+                }
+            }
+        }, expression.value);
+    }
+
+    void foldRoot(Expression& expression) {
+        const size_t before = count(expression);
+        fold(expression);
+        eliminated_ += before - count(expression);
+    }
+
+    void fold(Statement& statement) {
+        std::visit([this]<class T>(T& stmt) {
+            if constexpr (std::is_same_v<T, VariableDeclarationStatement>) {
+                foldRoot(stmt.initializer);
+            }
+            else if constexpr (std::is_same_v<T, WhileStatement>) {
+                foldRoot(stmt.condition);
+                for (Statement& child : stmt.statements) {
+                    fold(child);
+                }
+            }
+            else {
+                foldRoot(stmt.expression);
+            }
+        }, statement.value);
+    }
+
+public:
+    explicit ConstantFolder(Arena& arena)
+        : arena_ {arena} {
+    }
+
+    void fold(Function& function) {
+        for (Statement& statement : function.statements) {
+            fold(statement);
+        }
+
+        if (function.lastExpression) {
+            foldRoot(*function.lastExpression);
+        }
+    }
+
+    /// Number of the expression nodes removed so far.
+    [[nodiscard]] size_t eliminated() const noexcept {
+        return eliminated_;
+    }
+};
+
+/// Returns the number of the expression nodes removed.
+inline size_t fold_constants(Unit& unit) {
+    ConstantFolder folder {unit.arena};
+    for (Function& function : unit.functions) {
+        folder.fold(function);
+    }
+
+    return folder.eliminated();
+}
+
+} // namespace skarn::ast
@@ -1,22 +1,31 @@
 #pragma once
 
+#include "Arena.h"
+#include "Symbol.h"
 #include "TypeTraits.h"
-#include <memory>
+#include "Types.h"
+#include <array>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <span>
 #include <string>
 #include <variant>
-#include <vector>
 
 namespace skarn::ast {
 
 struct Expression;
 
+/// Slot or function index that is not resolved yet, see resolve_slots.
+inline constexpr uint32_t unresolved_index = std::numeric_limits<uint32_t>::max();
+
 enum class UnaryOp {
     Plus,
     Minus,
 };
 
 struct UnaryExpression {
-    std::unique_ptr<Expression> arg;
+    Expression* arg;
     UnaryOp op;
 };
 
@@ -34,12 +43,13 @@ enum class BinaryOp {
 };
 
 struct BinaryExpression {
-    std::vector<Expression> args;
+    std::span<Expression> args;
     BinaryOp op;
 };
 
 struct VariableExpression {
-    std::string name;
+    Symbol name;
+    uint32_t slot {unresolved_index}; // in the frame of the function
 };
 
 struct ConstantExpression {
@@ -47,53 +57,64 @@ struct ConstantExpression {
 };
 
 struct FunctionCallExpression {
-    std::vector<Expression> args;
-    std::string name;
+    std::span<Expression> args;
+    Symbol name;
+    uint32_t callee {unresolved_index}; // index of the function in the unit, builtins stay unresolved
+};
+
+struct StringExpression {
+    Symbol value;
 };
 
+/// Expression node, children are allocated in the arena of the unit, so nodes are trivially copyable
+/// and are never destroyed one by one.
 struct Expression {
-    std::variant<ConstantExpression, VariableExpression, UnaryExpression, BinaryExpression, FunctionCallExpression> value;
+    std::variant<ConstantExpression, VariableExpression, UnaryExpression, BinaryExpression, FunctionCallExpression, StringExpression> value;
+    TypeInfo type; // see infer_types
 
     /*implicit*/ Expression() noexcept = default;
 
-    template <OneOf<ConstantExpression, VariableExpression, UnaryExpression, BinaryExpression, FunctionCallExpression> Arg>
+    template <OneOf<ConstantExpression, VariableExpression, UnaryExpression, BinaryExpression, FunctionCallExpression, StringExpression> Arg>
     /*implicit*/ Expression(Arg&& arg) noexcept
         : value {std::forward<Arg>(arg)} {
     }
 
-    static VariableExpression variable(std::string name) {
-        return VariableExpression {std::move(name)};
+    static VariableExpression variable(const Symbol name) {
+        return VariableExpression {name};
     }
 
     static ConstantExpression constant(const int value) {
         return ConstantExpression {value};
     }
 
-    template <OneOf<Expression, ConstantExpression, VariableExpression, UnaryExpression, BinaryExpression, FunctionCallExpression> Arg>
-    static UnaryExpression unary(const UnaryOp op, Arg&& arg) {
-        std::unique_ptr<Expression> arg_ptr = std::make_unique<Expression>(std::forward<Arg>(arg));
-        return UnaryExpression {std::move(arg_ptr), op};
+    static StringExpression string(const Symbol value) {
+        return StringExpression {value};
     }
 
-    template <OneOf<Expression, ConstantExpression, VariableExpression, UnaryExpression, BinaryExpression, FunctionCallExpression>...Args>
-    static BinaryExpression binary(const BinaryOp op, Args&&...args) {
-        std::vector<Expression> args_vector;
-        ((args_vector.push_back(Expression {std::forward<Args>(args)})), ...);
-        return BinaryExpression {std::move(args_vector), op};
+    template <OneOf<Expression, ConstantExpression, VariableExpression, UnaryExpression, BinaryExpression, FunctionCallExpression, StringExpression> Arg>
+    static UnaryExpression unary(Arena& arena, const UnaryOp op, Arg&& arg) {
+        return UnaryExpression {arena.create<Expression>(std::forward<Arg>(arg)), op};
     }
 
-    template <OneOf<Expression, ConstantExpression, VariableExpression, UnaryExpression, BinaryExpression, FunctionCallExpression>...Args>
-    static FunctionCallExpression function(std::string name, Args&&...args) {
-        std::vector<Expression> args_vector;
-        ((args_vector.push_back(Expression {std::forward<Args>(args)})), ...);
-        return FunctionCallExpression {std::move(args_vector), std::move(name)};
+    template <OneOf<Expression, ConstantExpression, VariableExpression, UnaryExpression, BinaryExpression, FunctionCallExpression, StringExpression>...Args>
+    static BinaryExpression binary(Arena& arena, const BinaryOp op, Args&&...args) {
+        const std::array<Expression, sizeof...(Args)> args_array {Expression {std::forward<Args>(args)}...};
+        return BinaryExpression {arena.copy_array(args_array), op};
     }
 
-    static FunctionCallExpression function(std::string name, std::vector<Expression> args) {
-        return FunctionCallExpression {std::move(args), std::move(name)};
+    template <OneOf<Expression, ConstantExpression, VariableExpression, UnaryExpression, BinaryExpression, FunctionCallExpression, StringExpression>...Args>
+    static FunctionCallExpression function(Arena& arena, const Symbol name, Args&&...args) {
+        const std::array<Expression, sizeof...(Args)> args_array {Expression {std::forward<Args>(args)}...};
+        return FunctionCallExpression {arena.copy_array(args_array), name};
+    }
+
+    static FunctionCallExpression function(Arena& arena, const Symbol name, const std::span<const Expression> args) {
+        return FunctionCallExpression {arena.copy_array(args), name};
     }
 };
 
+static_assert(std::is_trivially_copyable_v<Expression> && std::is_trivially_destructible_v<Expression>);
+
 bool operator ==(const Expression& lhs, const Expression& rhs) noexcept;
 
 inline bool operator ==(const ConstantExpression& lhs, const ConstantExpression& rhs) noexcept {
@@ -104,8 +125,12 @@ inline bool operator ==(const VariableExpression& lhs, const VariableExpression&
     return lhs.name == rhs.name;
 }
 
+inline bool operator ==(const StringExpression& lhs, const StringExpression& rhs) noexcept {
+    return lhs.value == rhs.value;
+}
+
 inline bool operator ==(const UnaryExpression& lhs, const UnaryExpression& rhs) noexcept {
-    return lhs.op == rhs.op && (lhs.arg.get() == rhs.arg.get() || lhs.arg == nullptr || *lhs.arg == *rhs.arg);
+    return lhs.op == rhs.op && (lhs.arg == rhs.arg || lhs.arg != nullptr && rhs.arg != nullptr && *lhs.arg == *rhs.arg);
 }
 
 inline bool operator ==(const BinaryExpression& lhs, const BinaryExpression& rhs) noexcept {
@@ -147,14 +172,18 @@ inline bool operator ==(const Expression& lhs, const Expression& rhs) noexcept {
     }, lhs.value, rhs.value);
 }
 
-std::string to_string(const Expression& expr);
+std::string to_string(const Expression& expr, const SymbolTable& symbols);
 
-inline std::string to_string(const ConstantExpression& expr) {
+inline std::string to_string(const ConstantExpression& expr, [[maybe_unused]] const SymbolTable& symbols) {
     return std::to_string(expr.value);
 }
 
-inline std::string to_string(const VariableExpression& expr) {
-    return expr.name;
+inline std::string to_string(const VariableExpression& expr, const SymbolTable& symbols) {
+    return std::string {symbols.name(expr.name)};
+}
+
+inline std::string to_string(const StringExpression& expr, const SymbolTable& symbols) {
+    return std::format("\"{}\"", symbols.name(expr.value));
 }
 
 constexpr std::string_view to_string(const UnaryOp op) noexcept {
@@ -169,8 +198,8 @@ constexpr std::string_view to_string(const UnaryOp op) noexcept {
     }
 }
 
-inline std::string to_string(const UnaryExpression& expr) {
-    return std::format("{}{}", to_string(expr.op), expr.arg ? to_string(*expr.arg) : "null");
+inline std::string to_string(const UnaryExpression& expr, const SymbolTable& symbols) {
+    return std::format("{}{}", to_string(expr.op), expr.arg ? to_string(*expr.arg, symbols) : "null");
 }
 
 constexpr std::string_view to_string(const BinaryOp op) noexcept {
@@ -201,32 +230,31 @@ constexpr std::string_view to_string(const BinaryOp op) noexcept {
     }
 }
 
-inline std::string to_string(const BinaryExpression& expr) {
+inline std::string to_string(const BinaryExpression& expr, const SymbolTable& symbols) {
     std::string result {"("};
-    result += to_string(expr.args[0]);
+    result += to_string(expr.args[0], symbols);
     for (size_t i = 1; i < expr.args.size(); ++i) {
-        result += std::format(" {} {}", to_string(expr.op), to_string(expr.args[i]));
+        result += std::format(" {} {}", to_string(expr.op), to_string(expr.args[i], symbols));
     }
 
     result += ')';
     return result;
 }
 
-inline std::string to_string(const FunctionCallExpression& expr) {
-    std::string result = expr.name;
+inline std::string to_string(const FunctionCallExpression& expr, const SymbolTable& symbols) {
+    std::string result {symbols.name(expr.name)};
     result += '(';
-    result += to_string(expr.args[0]);
-    for (size_t i = 1; i < expr.args.size(); ++i) {
-        result += std::format(", {}", to_string(expr.args[i]));
+    for (size_t i = 0; i < expr.args.size(); ++i) {
+        result += std::format("{}{}", i != 0 ? ", " : "", to_string(expr.args[i], symbols));
     }
 
     result += ')';
     return result;
 }
 
-inline std::string to_string(const Expression& expr) {
-    return std::visit([](const auto& ex) {
-        return to_string(ex);
+inline std::string to_string(const Expression& expr, const SymbolTable& symbols) {
+    return std::visit([&symbols](const auto& ex) {
+        return to_string(ex, symbols);
     }, expr.value);
 }
 
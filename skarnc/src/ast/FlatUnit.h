@@ -0,0 +1,258 @@
+#pragma once
+
+#include "Unit.h"
+#include <cstdint>
+#include <format>
+#include <string>
+#include <span>
+#include <vector>
+
+namespace skarn::ast {
+
+enum class NodeKind : uint8_t {
+    Constant,           // data: index of the constant
+    Variable,           // data: name
+    Unary,              // op: UnaryOp, children: operand
+    Binary,             // op: BinaryOp, children: operands
+    FunctionCall,       // data: name, children: arguments
+    String,             // data: value
+    VariableDeclaration,// data: name, children: initializer
+    VariableAssignment, // data: name, children: expression
+    While,              // children: condition, statements
+    Return,             // children: expression
+    ExpressionStatement,// children: expression
+    LastExpression,     // children: expression
+    Argument,           // data: name
+    Function,           // data: name, children: arguments, statements, last expression
+};
+
+using NodeIndex = uint32_t;
+
+/// Struct-of-arrays encoding of a unit. Nodes are numbered in post-order, so the children of a node
+/// and the whole subtree precede it, and a pass over the unit is a linear scan of the arrays.
+/// Names are symbols of the table of the converted unit.
+class FlatUnit final {
+    std::vector<NodeKind> kinds_;
+    std::vector<uint8_t> ops_;
+    std::vector<uint32_t> data_;
+    std::vector<uint32_t> first_child_; // index into children_
+    std::vector<uint32_t> child_count_;
+    std::vector<NodeIndex> subtree_begin_;
+    std::vector<NodeIndex> children_;
+    std::vector<int> constants_;
+    std::vector<NodeIndex> functions_;
+
+    NodeIndex addNode(const NodeKind kind, const uint8_t op, const uint32_t data,
+        const std::span<const NodeIndex> children, const NodeIndex subtree_begin) {
+        const auto index = static_cast<NodeIndex>(kinds_.size());
+        kinds_.push_back(kind);
+        ops_.push_back(op);
+        data_.push_back(data);
+        first_child_.push_back(static_cast<uint32_t>(children_.size()));
+        child_count_.push_back(static_cast<uint32_t>(children.size()));
+        subtree_begin_.push_back(subtree_begin);
+        children_.insert(children_.end(), children.begin(), children.end());
+        return index;
+    }
+
+    [[nodiscard]] NodeIndex nextIndex() const noexcept {
+        return static_cast<NodeIndex>(kinds_.size());
+    }
+
+public:
+    [[nodiscard]] size_t size() const noexcept {
+        return kinds_.size();
+    }
+
+    [[nodiscard]] NodeKind kind(const NodeIndex node) const noexcept {
+        return kinds_[node];
+    }
+
+    [[nodiscard]] UnaryOp unary_op(const NodeIndex node) const noexcept {
+        return static_cast<UnaryOp>(ops_[node]);
+    }
+
+    [[nodiscard]] BinaryOp binary_op(const NodeIndex node) const noexcept {
+        return static_cast<BinaryOp>(ops_[node]);
+    }
+
+    [[nodiscard]] Symbol name(const NodeIndex node) const noexcept {
+        return Symbol {data_[node]};
+    }
+
+    [[nodiscard]] int constant(const NodeIndex node) const noexcept {
+        return constants_[data_[node]];
+    }
+
+    [[nodiscard]] std::span<const NodeIndex> children(const NodeIndex node) const noexcept {
+        return std::span {children_}.subspan(first_child_[node], child_count_[node]);
+    }
+
+    /// First node of the subtree, the subtree occupies the indices [subtree_begin(node), node].
+    [[nodiscard]] NodeIndex subtree_begin(const NodeIndex node) const noexcept {
+        return subtree_begin_[node];
+    }
+
+    [[nodiscard]] std::span<const NodeIndex> functions() const noexcept {
+        return functions_;
+    }
+
+    NodeIndex add(const Expression& expression) {
+        const NodeIndex begin = nextIndex();
+        return std::visit([&]<class T>(const T& expr) -> NodeIndex {
+            if constexpr (std::is_same_v<T, ConstantExpression>) {
+                constants_.push_back(expr.value);
+                return addNode(NodeKind::Constant, 0, static_cast<uint32_t>(constants_.size() - 1), {}, begin);
+            }
+            else if constexpr (std::is_same_v<T, VariableExpression>) {
+                return addNode(NodeKind::Variable, 0, expr.name.id, {}, begin);
+            }
+            else if constexpr (std::is_same_v<T, StringExpression>) {
+                return addNode(NodeKind::String, 0, expr.value.id, {}, begin);
+            }
+            else if constexpr (std::is_same_v<T, UnaryExpression>) {
+                const NodeIndex arg = add(*expr.arg);
+                return addNode(NodeKind::Unary, static_cast<uint8_t>(expr.op), 0, std::span {&arg, 1}, begin);
+            }
+            else {
+                std::vector<NodeIndex> args;
+                args.reserve(expr.args.size());
+                for (const Expression& arg : expr.args) {
+                    args.push_back(add(arg));
+                }
+
+                if constexpr (std::is_same_v<T, BinaryExpression>) {
+                    return addNode(NodeKind::Binary, static_cast<uint8_t>(expr.op), 0, args, begin);
+                }
+                else {
+                    return addNode(NodeKind::FunctionCall, 0, expr.name.id, args, begin);
+                }
+            }
+        }, expression.value);
+    }
+
+    NodeIndex add(const Statement& statement) {
+        const NodeIndex begin = nextIndex();
+        return std::visit([&]<class T>(const T& stmt) -> NodeIndex {
+            if constexpr (std::is_same_v<T, VariableDeclarationStatement>) {
+                const NodeIndex initializer = add(stmt.initializer);
+                return addNode(NodeKind::VariableDeclaration, 0, stmt.name.id, std::span {&initializer, 1}, begin);
+            }
+            else if constexpr (std::is_same_v<T, VariableAssignmentStatement>) {
+                const NodeIndex expression = add(stmt.expression);
+                return addNode(NodeKind::VariableAssignment, 0, stmt.name.id, std::span {&expression, 1}, begin);
+            }
+            else if constexpr (std::is_same_v<T, WhileStatement>) {
+                std::vector<NodeIndex> children;
+                children.reserve(stmt.statements.size() + 1);
+                children.push_back(add(stmt.condition));
+                for (const Statement& child : stmt.statements) {
+                    children.push_back(add(child));
+                }
+
+                return addNode(NodeKind::While, 0, 0, children, begin);
+            }
+            else {
+                const NodeIndex expression = add(stmt.expression);
+                constexpr NodeKind kind = std::is_same_v<T, ReturnStatement> ? NodeKind::Return : NodeKind::ExpressionStatement;
+                return addNode(kind, 0, 0, std::span {&expression, 1}, begin);
+            }
+        }, statement.value);
+    }
+
+    NodeIndex add(const Function& function) {
+        const NodeIndex begin = nextIndex();
+        std::vector<NodeIndex> children;
+        children.reserve(function.arguments.size() + function.statements.size() + 1);
+        for (const FunctionArgument& argument : function.arguments) {
+            children.push_back(addNode(NodeKind::Argument, 0, argument.name.id, {}, nextIndex()));
+        }
+
+        for (const Statement& statement : function.statements) {
+            children.push_back(add(statement));
+        }
+
+        if (function.lastExpression) {
+            const NodeIndex last_begin = nextIndex();
+            const NodeIndex expression = add(*function.lastExpression);
+            children.push_back(addNode(NodeKind::LastExpression, 0, 0, std::span {&expression, 1}, last_begin));
+        }
+
+        const NodeIndex index = addNode(NodeKind::Function, 0, function.name.id, children, begin);
+        functions_.push_back(index);
+        return index;
+    }
+
+    /// Calls visitor(node) for every node of the subtree, children before their parent.
+    template <std::invocable<NodeIndex> Visitor>
+    void visit_post_order(const NodeIndex root, Visitor&& visitor) const {
+        for (NodeIndex node = subtree_begin_[root]; node <= root; ++node) {
+            visitor(node);
+        }
+    }
+
+    /// Computes a value for every node of the subtree from the values of its children,
+    /// f(node, children_values) is called in post-order and the value of the root is returned.
+    template <class T, class F>
+    requires (std::is_invocable_r_v<T, F&, NodeIndex, std::span<T>>)
+    [[nodiscard]] T fold(const NodeIndex root, F f) const {
+        std::vector<T> stack;
+        for (NodeIndex node = subtree_begin_[root]; node <= root; ++node) {
+            const size_t count = child_count_[node];
+            T value = f(node, std::span {stack}.last(count));
+            stack.resize(stack.size() - count);
+            stack.push_back(std::move(value));
+        }
+
+        return std::move(stack.back());
+    }
+};
+
+inline FlatUnit flatten(const Unit& unit) {
+    FlatUnit result;
+    for (const Function& function : unit.functions) {
+        result.add(function);
+    }
+
+    return result;
+}
+
+/// Formats an expression node the same way as the tree expression.
+inline std::string to_string(const FlatUnit& unit, const NodeIndex node, const SymbolTable& symbols) {
+    return unit.fold<std::string>(node, [&](const NodeIndex index, const std::span<std::string> args) {
+        switch (unit.kind(index)) {
+            case NodeKind::Constant:
+                return std::to_string(unit.constant(index));
+            case NodeKind::Variable:
+                return std::string {symbols.name(unit.name(index))};
+            case NodeKind::String:
+                return std::format("\"{}\"", symbols.name(unit.name(index)));
+            case NodeKind::Unary:
+                return std::format("{}{}", to_string(unit.unary_op(index)), args[0]);
+            case NodeKind::Binary: {
+                std::string result {"("};
+                result += args[0];
+                for (size_t i = 1; i < args.size(); ++i) {
+                    result += std::format(" {} {}", to_string(unit.binary_op(index)), args[i]);
+                }
+
+                result += ')';
+                return result;
+            }
+            case NodeKind::FunctionCall: {
+                std::string result {symbols.name(unit.name(index))};
+                result += '(';
+                for (size_t i = 0; i < args.size(); ++i) {
+                    result += std::format("{}{}", i != 0 ? ", " : "", args[i]);
+                }
+
+                result += ')';
+                return result;
+            }
+            default:
+                return std::string {"?"};
+        }
+    });
+}
+
+} // namespace skarn::ast
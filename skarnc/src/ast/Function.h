@@ -1,19 +1,23 @@
 #pragma once
 
 #include "Statement.h"
+#include <optional>
+#include <vector>
 
 namespace skarn::ast {
 
 struct FunctionArgument {
-    std::string name;
+    Symbol name;
     TypeInfo type;
 };
 
 struct Function {
-    std::string name;
+    Symbol name;
     std::vector<FunctionArgument> arguments;
     std::vector<Statement> statements;
     std::optional<Expression> lastExpression;
+    uint32_t slotCount {}; // size of the frame, arguments occupy the first slots
+    TypeInfo returnType; // see infer_types
 };
 
 } // namespace skarn::ast
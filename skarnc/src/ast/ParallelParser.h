@@ -0,0 +1,232 @@
+#pragma once
+
+#include "Parser.h"
+#include "ThreadPool.h"
+#include "parser/details/Simd.h"
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace skarn::ast {
+
+/// Splits a source into slices of one top-level function each, the whitespace before a function belongs to its slice.
+/// Functions are found by matching braces outside strings, which end at a quote or a newline. With SSE2 the source is
+/// scanned 16 bytes at a time and only braces, quotes and newlines are visited.
+/// Returns nullopt if the braces do not match or something else than whitespace follows the last function.
+inline std::optional<std::vector<std::string_view>> split_functions(const std::string_view source) {
+    std::vector<std::string_view> slices;
+    size_t begin = 0;
+    size_t depth = 0;
+    bool in_string = false;
+    const auto visit = [&](const size_t offset) {
+        const char chr = source[offset];
+        if (in_string) {
+            in_string = chr != '"' && chr != '\n';
+        }
+        else if (chr == '"') {
+            in_string = true;
+        }
+        else if (chr == '{') {
+            ++depth;
+        }
+        else if (chr == '}') {
+            if (depth == 0) {
+                return false;
+            }
+
+            if (--depth == 0) {
+                slices.push_back(source.substr(begin, offset + 1 - begin));
+                begin = offset + 1;
+            }
+        }
+
+        return true;
+    };
+
+    const char* const data = source.data();
+    const size_t size = source.size();
+    size_t i = 0;
+
+#ifdef SKARN_PARSER_SSE2
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; i + 16 <= size; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i matches = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, open), _mm_cmpeq_epi8(chunk, close)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, newline)));
+        for (auto mask = static_cast<uint32_t>(_mm_movemask_epi8(matches)); mask != 0; mask &= mask - 1) {
+            if (!visit(i + static_cast<size_t>(std::countr_zero(mask)))) {
+                return std::nullopt;
+            }
+        }
+    }
+#endif
+
+    for (; i < size; ++i) {
+        const char chr = data[i];
+        if ((chr == '{' || chr == '}' || chr == '"' || chr == '\n') && !visit(i)) {
+            return std::nullopt;
+        }
+    }
+
+    if (depth != 0 || source.find_first_not_of(" \t\n\r", begin) != std::string_view::npos) {
+        return std::nullopt;
+    }
+
+    return slices;
+}
+
+namespace details {
+/// Moves the names of a function parsed with another symbol table to the table of the unit.
+class SymbolMover final {
+    const SymbolTable& from_;
+    SymbolTable& to_;
+    std::vector<uint32_t>& ids_; // by the id in from_, unresolved_index if not moved yet
+
+    void move(Symbol& symbol) {
+        if (symbol.id >= ids_.size()) {
+            ids_.resize(from_.size(), unresolved_index);
+        }
+
+        uint32_t& id = ids_[symbol.id];
+        if (id == unresolved_index) {
+            id = to_.intern(from_.name(symbol)).id;
+        }
+
+        symbol.id = id;
+    }
+
+    void move(Expression& expression) {
+        std::visit([this]<class T>(T& expr) {
+            if constexpr (std::is_same_v<T, VariableExpression>) {
+                move(expr.name);
+            }
+            else if constexpr (std::is_same_v<T, StringExpression>) {
+                move(expr.value);
+            }
+            else if constexpr (std::is_same_v<T, UnaryExpression>) {
+                move(*expr.arg);
+            }
+            else if constexpr (OneOf<T, BinaryExpression, FunctionCallExpression>) {
+                for (Expression& arg : expr.args) {
+                    move(arg);
+                }
+
+                if constexpr (std::is_same_v<T, FunctionCallExpression>) {
+                    move(expr.name);
+                }
+            }
+        }, expression.value);
+    }
+
+    void move(Statement& statement) {
+        std::visit([this]<class T>(T& stmt) {
+            if constexpr (std::is_same_v<T, VariableDeclarationStatement>) {
+                move(stmt.name);
+                move(stmt.initializer);
+            }
+            else if constexpr (std::is_same_v<T, VariableAssignmentStatement>) {
+                move(stmt.name);
+                move(stmt.expression);
+            }
+            else if constexpr (std::is_same_v<T, WhileStatement>) {
+                move(stmt.condition);
+                for (Statement& child : stmt.statements) {
+                    move(child);
+                }
+            }
+            else {
+                move(stmt.expression);
+            }
+        }, statement.value);
+    }
+
+public:
+    SymbolMover(const SymbolTable& from, SymbolTable& to, std::vector<uint32_t>& ids) noexcept
+        : from_ {from}
+        , to_ {to}
+        , ids_ {ids} {
+    }
+
+    void move(Function& function) {
+        move(function.name);
+        for (FunctionArgument& argument : function.arguments) {
+            move(argument.name);
+        }
+
+        for (Statement& statement : function.statements) {
+            move(statement);
+        }
+
+        if (function.lastExpression) {
+            move(*function.lastExpression);
+        }
+    }
+};
+} // namespace details
+
+/// Parses the functions of a large source in parallel, the result is the same as of parse_unit(source) except
+/// for the order of the symbol ids, which only depends on the source.
+/// The source is split with split_functions, each worker parses its slices with its own symbol table and arena,
+/// the names are then moved to the table of the unit in the order of the functions. A context of a slice spans
+/// the source up to the end of the slice and starts at the slice, so offsets, lines and columns are absolute.
+/// If several functions fail, the messages of the first one are returned. Small sources and sources that cannot
+/// be split are parsed sequentially.
+inline parser::ParserResult<Unit> parse_unit(const std::string_view source, ThreadPool& pool) {
+    using namespace parser;
+
+    std::optional<std::vector<std::string_view>> split = split_functions(source);
+    if (!split || pool.thread_count() == 1 || split->size() < ThreadPool::min_parallel_count) {
+        return parse_unit(source);
+    }
+
+    const std::vector<std::string_view>& slices = *split;
+    std::vector<Function> functions(slices.size());
+    std::vector<uint32_t> workers(slices.size());
+    std::vector<std::optional<ParseMessages>> errors(slices.size());
+    std::vector<SymbolTable> symbols(pool.thread_count());
+    std::vector<Arena> arenas(pool.thread_count());
+    pool.parallel_for(slices.size(), [&](const size_t index, const size_t worker) {
+        const size_t begin = static_cast<size_t>(slices[index].data() - source.data());
+        ParserContext<char> ctx {source.substr(0, begin + slices[index].size())};
+        ctx.position(ParserPosition {begin});
+        ctx.error_mode(ParserErrorMode::Farthest);
+        ctx.user_data(symbols[worker]);
+        ctx.user_data(arenas[worker]);
+
+        workers[index] = static_cast<uint32_t>(worker);
+        if (!grammar::unitFunction.parser().parse(ctx, functions[index]) || !ctx.input().empty()) {
+            if (ctx.message_records().empty()) {
+                ctx.add_message(ParserMsgLevel::Error, ParserMsgCode::C0002, "function");
+            }
+
+            errors[index] = ctx.messages();
+        }
+    });
+
+    for (std::optional<ParseMessages>& error : errors) {
+        if (error) {
+            return std::unexpected(std::move(*error));
+        }
+    }
+
+    Unit unit;
+    std::vector<std::vector<uint32_t>> ids(pool.thread_count());
+    for (size_t index = 0; index < functions.size(); ++index) {
+        details::SymbolMover {symbols[workers[index]], unit.symbols, ids[workers[index]]}.move(functions[index]);
+    }
+
+    unit.functions = std::move(functions);
+    for (Arena& arena : arenas) {
+        unit.arena.merge(std::move(arena));
+    }
+
+    return unit;
+}
+
+} // namespace skarn::ast
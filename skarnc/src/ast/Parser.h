@@ -3,77 +3,219 @@
 #include "ast/Unit.h"
 #include "ast/Expression.h"
 #include "parser/Parser.h"
+#include <algorithm>
 
 namespace skarn::ast {
 
-consteval auto create_parser() noexcept {
-    using namespace std::string_view_literals;
-    using namespace skarn::parser;
+/// The grammar of units. Recursive rules are bound at compile time, so the parsers are immutable and can be used
+/// from any number of threads concurrently.
+namespace grammar {
+using namespace std::string_view_literals;
+using namespace skarn::parser;
+
+struct ExpressionRule;
+struct StatementRule;
+
+inline constexpr auto ws_many = *~Parse::ws();
+inline constexpr auto ws_at_least_once = +~Parse::ws();
+
+inline constexpr auto unary_op =
+    Parse::char_('+').value(UnaryOp::Plus) ||
+    Parse::char_('-').value(UnaryOp::Minus);
+
+inline constexpr auto product_op =
+    Parse::char_('*').value(BinaryOp::Multiply) ||
+    Parse::char_('/').value(BinaryOp::Divide);
+
+inline constexpr auto sum_op =
+    Parse::char_('+').value(BinaryOp::Add) ||
+    Parse::char_('-').value(BinaryOp::Subtract);
+
+inline constexpr auto compare_op =
+    Parse::literal("!="sv).value(BinaryOp::NotEqual) ||
+    Parse::literal("=="sv).value(BinaryOp::Equal) ||
+    Parse::literal("<="sv).value(BinaryOp::LessThanOrEqual) ||
+    Parse::literal("<"sv).value(BinaryOp::LessThan) ||
+    Parse::literal(">="sv).value(BinaryOp::GreaterThanOrEqual) ||
+    Parse::literal(">"sv).value(BinaryOp::GreaterThan);
+
+inline constexpr auto ident = (Parse::char_([](const char c) static noexcept {
+        return c >= 'a' && c <= 'z' || c >= 'A' && c <= 'Z' || c == '_';
+    }, "identifier"sv) >>
+    *Parse::char_([](const char c) static noexcept {
+        return c >= 'a' && c <= 'z' || c >= 'A' && c <= 'Z' || c >= '0' && c <= '9' || c == '_';
+    }, "identifier"sv)).capture() >>
+    [](ParserContext<char>& ctx, Symbol& result, const std::string_view name) static {
+        result = ctx.user_data<SymbolTable>().intern(name);
+    };
 
-    constexpr auto ws_many = *~Parse::ws();
-    constexpr auto ws_at_least_one = +~Parse::ws();
+inline constexpr auto expressionRef = Parse::rule<ExpressionRule, Expression>();
+inline constexpr auto statementRef = Parse::rule<StatementRule, Statement>();
 
-    constexpr auto product_op = Parse::char_([](const char c) static noexcept {
-            return c == '*' || c == '/';
-        });
+inline constexpr auto constantExpression =
+    Parse::integer<int>() >>
+    [](Expression& result, const int value) static {
+        result = Expression::constant(value);
+    };
 
-    constexpr auto sum_op = Parse::char_([](const char c) static noexcept {
-            return c == '+' || c == '-';
-        });
+inline constexpr auto stringExpression =
+    ~Parse::char_('"') >>
+    (*Parse::char_([](const char c) static noexcept {
+        return c != '"' && c != '\n';
+    }, "string character"sv)).capture() >>
+    ~Parse::char_('"') >>
+    [](ParserContext<char>& ctx, Expression& result, const std::string_view value) static {
+        result = Expression::string(ctx.user_data<SymbolTable>().intern(value));
+    };
 
-    constexpr auto ident = Parse::char_([](const char c) static noexcept {
-            return c >= 'a' && c <= 'z' || c >= 'A' && c <= 'Z' || c == '_';
-        }, "identifier"sv) >>
-        *Parse::char_([](const char c) static noexcept {
-            return c >= 'a' && c <= 'z' || c >= 'A' && c <= 'Z' || c >= '0' && c <= '9' || c == '_';
-        }, "identifier"sv) >>
-        [](std::string& result, std::tuple<char, std::string>& value) static {
-            result = std::get<0>(value) + std::move(std::get<1>(value));
-        };
+inline constexpr auto variableExpression =
+    ident >> [](Expression& result, const Symbol value) static {
+        result = Expression::variable(value);
+    };
 
-    constexpr auto expressionRef = Parse::ref<Expression>();
+inline constexpr auto bracketExpression =
+    ~Parse::char_('(') >> ws_many >> expressionRef >> ws_many >> ~Parse::char_(')');
+
+inline constexpr auto functionCallExpression =
+    ident >> ws_many >> ~Parse::char_('(') >> ws_many >>
+    (expressionRef >> *(ws_many >> ~Parse::char_(',') >> ws_many >> expressionRef)).optional() >> ws_many >>
+    ~Parse::char_(')') >>
+    [](ParserContext<char>& ctx, Expression& result,
+        std::tuple<Symbol, std::optional<std::tuple<Expression, std::vector<Expression>>>>& value) static {
+        std::vector<Expression> args;
+        if (std::optional<std::tuple<Expression, std::vector<Expression>>>& args_value = std::get<1>(value)) {
+            args.push_back(std::get<0>(args_value.value()));
+            args.append_range(std::get<1>(args_value.value()));
+        }
+
+        result = Expression::function(ctx.user_data<Arena>(), std::get<0>(value), args);
+    };
+
+inline constexpr auto simpleExpression =
+    constantExpression || stringExpression || functionCallExpression || variableExpression || bracketExpression;
+
+inline constexpr auto unaryExpression = *(ws_many >> unary_op) >> ws_many >> simpleExpression >>
+    [](ParserContext<char>& ctx, Expression& result, std::tuple<std::vector<UnaryOp>, Expression>& value) static {
+        const size_t minusCount = std::ranges::count(std::get<0>(value), UnaryOp::Minus);
+        if (minusCount % 2 == 0) {
+            result = std::get<1>(value);
+        }
+        else {
+            result = Expression::unary(ctx.user_data<Arena>(), UnaryOp::Minus, std::move(std::get<1>(value)));
+        }
+    };
 
-    constexpr auto constantExpression = Parse::integer<int>() >> [](Expression& expression, const int value) static {
-        expression.value = ConstantExpression {value};
+inline constexpr auto combineBinary =
+    [](ParserContext<char>& ctx, Expression& result, const BinaryOp op, Expression& rhs) static {
+        result = Expression::binary(ctx.user_data<Arena>(), op, std::move(result), std::move(rhs));
     };
 
-    constexpr auto variableExpression = ident >> [](Expression& expression, std::string& value) static {
-        expression.value = VariableExpression {std::move(value)};
+inline constexpr auto expression =
+    Parse::precedence(unaryExpression, combineBinary,
+        Parse::left(ws_many >> compare_op >> ws_many),
+        Parse::left(ws_many >> sum_op >> ws_many),
+        Parse::left(ws_many >> product_op >> ws_many)).expected("expression"sv);
+
+inline constexpr auto variableDeclaration =
+    ~Parse::literal("let"sv) >> ws_at_least_once >> ident >> ws_many >>
+    ~Parse::char_('=') >> ws_many >> expressionRef >> ws_many >> ~Parse::char_(';') >>
+    [](Statement& result, std::tuple<Symbol, Expression>& value) static {
+        result = Statement::variableDeclaration(std::get<0>(value), std::get<1>(value));
     };
 
-    constexpr auto bracketExpression = ~Parse::char_('(') >> ws_many >> expressionRef >> ws_many >> ~Parse::char_(')');
-    constexpr auto simpleExpression = *sum_op >> (constantExpression || variableExpression || bracketExpression);
-    constexpr auto productExpression = simpleExpression >> ws_many >> *(product_op >> ws_many >> simpleExpression);
-    constexpr auto sumExpression = productExpression >> ws_many >> *(sum_op >> ws_many >> productExpression);
-    constexpr auto expression = sumExpression;
-    expressionRef.assign(expression);
+inline constexpr auto variableAssignment =
+    ident >> ws_many >> ~Parse::char_('=') >> ws_many >> expressionRef >> ws_many >> ~Parse::char_(';') >>
+    [](Statement& result, std::tuple<Symbol, Expression>& value) static {
+        result = Statement::variableAssignment(std::get<0>(value), std::get<1>(value));
+    };
 
-    constexpr auto variableDeclaration =
-        ~Parse::literal("let"sv) >> ws_at_least_one >> ident >> ws_many >>
-        ~Parse::char_('=') >> ws_many >> expression >>
-        ~Parse::char_(';');
+inline constexpr auto returnStatement =
+    ~Parse::keyword("return"sv) >> ws_many >> expressionRef >> ws_many >> ~Parse::char_(';') >>
+    [](Statement& result, Expression& value) static {
+        result = Statement::returnStatement(value);
+    };
 
-    constexpr auto variableAssignment =
-        ident >> ws_many >> ~Parse::char_('=') >> ws_many >> expression >>
-        ~Parse::char_(';');
+inline constexpr auto whileStatement =
+    ~Parse::literal("while"sv) >> ws_at_least_once >> expressionRef >> ws_many >>
+    ~Parse::char_('{') >> ws_many >> *(statementRef >> ws_many) >>
+    ~Parse::char_('}') >>
+    [](Statement& result, std::tuple<Expression, std::vector<Statement>>& value) static {
+        result = Statement::whileStatement(std::get<0>(value), std::move(std::get<1>(value)));
+    };
 
-    constexpr auto whileLoop =
-        ~Parse::literal("while"sv) >> ws_at_least_one >> expression >> ws_many >>
-        ~Parse::char_('{') >> ws_many >> statement >> ws_many >> ~Parse::char_('}');
+inline constexpr auto expressionStatement =
+    expressionRef >> ws_many >> ~Parse::char_(';') >>
+    [](Statement& result, Expression& value) static {
+        result = Statement::expressionStatement(value);
+    };
 
-    constexpr auto statement = variableDeclaration || variableAssignment || whileLoop;
+inline constexpr auto statement =
+    returnStatement || variableDeclaration || variableAssignment || whileStatement || expressionStatement;
+
+struct ExpressionRule {
+    static constexpr auto definition = expression;
+};
+
+struct StatementRule {
+    static constexpr auto definition = statement;
+};
+
+inline constexpr auto function =
+    ~Parse::literal("fn"sv) >> ws_at_least_once >> ident >> ws_many >>
+    ~Parse::char_('(') >> ws_many >> ident.seq(ws_many >> ',' >> ws_many).optional() >> ws_many >> ~Parse::char_(')') >> ws_many >>
+    ~Parse::char_('{') >> ws_many >> *(statementRef >> ws_many) >> expressionRef.optional() >> ws_many >> ~Parse::char_('}') >>
+    [](Function& result,
+        std::tuple<Symbol, std::optional<std::vector<Symbol>>, std::vector<Statement>, std::optional<Expression>>& value) static {
+        result.name = std::get<0>(value);
+        for (const Symbol arg : std::get<1>(value).value_or(std::vector<Symbol> {})) {
+            result.arguments.push_back(FunctionArgument {
+                .name = arg,
+                .type = {},
+            });
+        }
+
+        result.statements = std::move(std::get<2>(value));
+        result.lastExpression = std::get<3>(value);
+    };
 
-    constexpr auto function =
-        ~Parse::literal("fn"sv) >> ws_at_least_one >> ident >> ws_many >>
-        ~Parse::char_('(') >> ws_many >> ident.seq(ws_many >> ',' >> ws_many) >> ws_many >> ~Parse::char_(')') >> ws_many >>
-        ~Parse::char_('{') >> ws_many >> *(statement >> ws_many) >> expression.optional() >> ws_many >> ~Parse::char_('}');
+inline constexpr auto unit = ws_many >> *(function >> ws_many) >>
+    [](Unit& result, std::vector<Function>& value) static {
+        result.functions = std::move(value);
+    };
 
-    constexpr auto unitParser = *function.wrap(ws_many) >>
-        [](Unit& unit, std::vector<Function>& functions) static noexcept {
-            unit.functions = std::move(functions);
-        };
+/// A function with the whitespace before it, a slice of a unit, see split_functions.
+inline constexpr auto unitFunction = ws_many >> function;
+} // namespace grammar
+
+/// Parses a whole unit using a context prepared by the caller, e.g. with chunked input.
+/// The unit owns its names and nodes, the source is not referenced.
+inline parser::ParserResult<Unit> parse_unit(parser::ParserContext<char>& ctx) {
+    using namespace parser;
+
+    SymbolTable symbols;
+    Arena arena;
+    ctx.error_mode(ParserErrorMode::Farthest);
+    ctx.user_data(symbols);
+    ctx.user_data(arena);
+
+    Unit unit;
+    if (!grammar::unit.parser().parse(ctx, unit) || !ctx.input().empty()) {
+        if (ctx.message_records().empty()) {
+            ctx.add_message(ParserMsgLevel::Error, ParserMsgCode::C0002, "function");
+        }
+
+        return std::unexpected(ctx.messages());
+    }
+
+    unit.symbols = std::move(symbols);
+    unit.arena = std::move(arena);
+    return unit;
+}
 
-    return unitParser;
+/// Parses a whole source file. The unit owns its names and nodes, the source is not referenced.
+inline parser::ParserResult<Unit> parse_unit(const std::string_view source) {
+    parser::ParserContext<char> ctx {source};
+    return parse_unit(ctx);
 }
 
 } // namespace skarn::ast
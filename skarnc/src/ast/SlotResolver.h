@@ -0,0 +1,179 @@
+#pragma once
+
+#include "Unit.h"
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace skarn::ast {
+
+/// Resolves variables to slots of the function frame and calls to function indices, so that
+/// execution does not look names up. Calls to names that are not functions of the unit stay
+/// unresolved and are left to the backend, e.g. builtins.
+/// A declaration takes a new slot, which the name refers to until the end of the block: the function
+/// or the body of a while. A declaration of a visible name shadows it and is reported, see warnings().
+/// Names are bound in tables indexed by symbol id and a block restores the bindings it hid from an undo log,
+/// so the pass is linear and lookups neither hash nor allocate.
+class SlotResolver final {
+    const SymbolTable& symbols_;
+    std::vector<uint32_t> functions_;                 // function index by symbol id
+    std::vector<uint32_t> bindings_;                  // slot by symbol id, unresolved_index if not visible
+    std::vector<std::pair<Symbol, uint32_t>> hidden_; // declarations of the open blocks and the bindings they hid
+    std::vector<std::string> warnings_;
+    Symbol function_name_;
+    uint32_t slot_count_ {};
+
+    [[nodiscard]] std::string message(const std::string_view what, const Symbol name) const {
+        return std::format("{} '{}' in function '{}'", what, symbols_.name(name), symbols_.name(function_name_));
+    }
+
+    [[noreturn]] void fail(const std::string_view what, const Symbol name) const {
+        throw std::runtime_error {message(what, name)};
+    }
+
+    [[nodiscard]] uint32_t binding(const Symbol name) const noexcept {
+        return name.id < bindings_.size() ? bindings_[name.id] : unresolved_index;
+    }
+
+    [[nodiscard]] uint32_t lookup(const Symbol name) const {
+        const uint32_t slot = binding(name);
+        if (slot == unresolved_index) {
+            fail("undefined variable", name);
+        }
+
+        return slot;
+    }
+
+    uint32_t declare(const Symbol name) {
+        if (name.id >= bindings_.size()) {
+            bindings_.resize(name.id + 1, unresolved_index);
+        }
+
+        if (bindings_[name.id] != unresolved_index) {
+            warnings_.push_back(message("shadowed variable", name));
+        }
+
+        hidden_.emplace_back(name, bindings_[name.id]);
+        bindings_[name.id] = slot_count_;
+        return slot_count_++;
+    }
+
+    void close_block(const size_t mark) noexcept {
+        while (hidden_.size() > mark) {
+            bindings_[hidden_.back().first.id] = hidden_.back().second;
+            hidden_.pop_back();
+        }
+    }
+
+    void resolve(Expression& expression) {
+        std::visit([this]<class T>(T& expr) {
+            if constexpr (std::is_same_v<T, VariableExpression>) {
+                expr.slot = lookup(expr.name);
+            }
+            else if constexpr (std::is_same_v<T, UnaryExpression>) {
+                resolve(*expr.arg);
+            }
+            else if constexpr (OneOf<T, BinaryExpression, FunctionCallExpression>) {
+                for (Expression& arg : expr.args) {
+                    resolve(arg);
+                }
+
+                if constexpr (std::is_same_v<T, FunctionCallExpression>) {
+                    if (expr.name.id < functions_.size()) {
+                        expr.callee = functions_[expr.name.id];
+                    }
+                }
+            }
+        }, expression.value);
+    }
+
+    void resolve(Statement& statement) {
+        std::visit([this]<class T>(T& stmt) {
+            if constexpr (std::is_same_v<T, VariableDeclarationStatement>) {
+                resolve(stmt.initializer); // the initializer does not see the new variable
+                stmt.slot = declare(stmt.name);
+            }
+            else if constexpr (std::is_same_v<T, VariableAssignmentStatement>) {
+                resolve(stmt.expression);
+                stmt.slot = lookup(stmt.name);
+            }
+            else if constexpr (std::is_same_v<T, WhileStatement>) {
+                resolve(stmt.condition);
+                const size_t mark = hidden_.size();
+                for (Statement& child : stmt.statements) {
+                    resolve(child);
+                }
+
+                close_block(mark);
+            }
+            else {
+                resolve(stmt.expression);
+            }
+        }, statement.value);
+    }
+
+public:
+    explicit SlotResolver(const Unit& unit)
+        : symbols_ {unit.symbols}
+        , functions_(unit.symbols.size(), unresolved_index)
+        , bindings_(unit.symbols.size(), unresolved_index) {
+        for (uint32_t index = 0; index != unit.functions.size(); ++index) {
+            function_name_ = unit.functions[index].name;
+            uint32_t& function = functions_[function_name_.id];
+            if (function != unresolved_index) {
+                fail("duplicate function", function_name_);
+            }
+
+            function = index;
+        }
+    }
+
+    void resolve(Function& function) {
+        close_block(0); // bindings left by a function that failed
+        function_name_ = function.name;
+        slot_count_ = 0;
+
+        for (const FunctionArgument& argument : function.arguments) {
+            if (binding(argument.name) != unresolved_index) {
+                fail("duplicate argument", argument.name);
+            }
+
+            std::ignore = declare(argument.name);
+        }
+
+        for (Statement& statement : function.statements) {
+            resolve(statement);
+        }
+
+        if (function.lastExpression) {
+            resolve(*function.lastExpression);
+        }
+
+        close_block(0);
+        function.slotCount = slot_count_;
+    }
+
+    /// Shadowed variables, a warning per declaration.
+    [[nodiscard]] const std::vector<std::string>& warnings() const noexcept {
+        return warnings_;
+    }
+
+    /// Returns the warnings reported so far and clears them.
+    [[nodiscard]] std::vector<std::string> take_warnings() noexcept {
+        return std::exchange(warnings_, {});
+    }
+};
+
+/// Returns the warnings, see SlotResolver.
+inline std::vector<std::string> resolve_slots(Unit& unit) {
+    SlotResolver resolver {unit};
+    for (Function& function : unit.functions) {
+        resolver.resolve(function);
+    }
+
+    return resolver.warnings();
+}
+
+} // namespace skarn::ast
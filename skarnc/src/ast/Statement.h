@@ -2,21 +2,24 @@
 
 #include "Expression.h"
 #include "Types.h"
+#include <vector>
 
 namespace skarn::ast {
 
 struct Statement;
 
 struct VariableDeclarationStatement {
-    std::string name;
+    Symbol name;
     TypeInfo type;
     Expression initializer;
+    uint32_t slot {unresolved_index};
 };
 
 struct VariableAssignmentStatement {
-    std::string name;
+    Symbol name;
     TypeInfo type;
     Expression expression;
+    uint32_t slot {unresolved_index};
 };
 
 struct WhileStatement {
@@ -28,28 +31,36 @@ struct ReturnStatement {
     Expression expression;
 };
 
+struct ExpressionStatement {
+    Expression expression;
+};
+
 struct Statement {
-    std::variant<VariableDeclarationStatement, VariableAssignmentStatement, WhileStatement, ReturnStatement> value;
+    std::variant<VariableDeclarationStatement, VariableAssignmentStatement, WhileStatement, ReturnStatement, ExpressionStatement> value;
 
     Statement() = default;
 
-    template <OneOf<VariableDeclarationStatement, VariableAssignmentStatement, WhileStatement, ReturnStatement> Arg>
+    template <OneOf<VariableDeclarationStatement, VariableAssignmentStatement, WhileStatement, ReturnStatement, ExpressionStatement> Arg>
     /* implicit */ Statement(Arg&& arg) noexcept
         : value {std::forward<Arg>(arg)} {
     }
 
-    static VariableDeclarationStatement variableDeclaration(std::string name, Expression initializer) {
-        return VariableDeclarationStatement {std::move(name), {}, std::move(initializer)};
+    static VariableDeclarationStatement variableDeclaration(const Symbol name, Expression initializer) {
+        return VariableDeclarationStatement {name, {}, std::move(initializer)};
     }
 
-    static VariableAssignmentStatement variableAssignment(std::string name, Expression initializer) {
-        return VariableAssignmentStatement {std::move(name), {}, std::move(initializer)};
+    static VariableAssignmentStatement variableAssignment(const Symbol name, Expression initializer) {
+        return VariableAssignmentStatement {name, {}, std::move(initializer)};
     }
 
     static ReturnStatement returnStatement(Expression expression) {
         return ReturnStatement {std::move(expression)};
     }
 
+    static ExpressionStatement expressionStatement(Expression expression) {
+        return ExpressionStatement {std::move(expression)};
+    }
+
     static WhileStatement whileStatement(Expression expression, std::vector<Statement> statements) {
         return WhileStatement {std::move(expression), std::move(statements)};
     }
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Arena.h"
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace skarn::ast {
+
+/// Interned name, see SymbolTable. The default symbol is the empty name.
+struct Symbol {
+    uint32_t id {};
+
+    constexpr auto operator <=>(const Symbol&) const noexcept = default;
+};
+
+/// Interns names into 32-bit symbols, so names are compared and hashed as integers.
+/// The characters are stored in an arena and stay valid for the lifetime of the table.
+class SymbolTable final {
+    Arena arena_ {4 * 1024};
+    std::vector<std::string_view> names_;
+    std::vector<uint32_t> hashes_;
+    std::vector<uint32_t> slots_; // open addressing, symbol id + 1, 0 for an empty slot
+
+    static constexpr uint32_t hash(const std::string_view name) noexcept {
+        uint32_t result = 2166136261U; // FNV-1a
+        for (const char chr : name) {
+            result = (result ^ static_cast<unsigned char>(chr)) * 16777619U;
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] size_t findSlot(const std::string_view name, const uint32_t name_hash) const noexcept {
+        const size_t mask = slots_.size() - 1;
+        for (size_t slot = name_hash & mask;; slot = (slot + 1) & mask) {
+            const uint32_t entry = slots_[slot];
+            if (entry == 0 || hashes_[entry - 1] == name_hash && names_[entry - 1] == name) {
+                return slot;
+            }
+        }
+    }
+
+    void grow() {
+        std::vector<uint32_t> slots(slots_.empty() ? 64 : slots_.size() * 2);
+        const size_t mask = slots.size() - 1;
+        for (uint32_t id = 0; id != names_.size(); ++id) {
+            size_t slot = hashes_[id] & mask;
+            while (slots[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+
+            slots[slot] = id + 1;
+        }
+
+        slots_ = std::move(slots);
+    }
+
+public:
+    SymbolTable() {
+        std::ignore = intern({});
+    }
+
+    [[nodiscard]] Symbol intern(const std::string_view name) {
+        if ((names_.size() + 1) * 4 > slots_.size() * 3) { // keeps the load factor below 3/4
+            grow();
+        }
+
+        const uint32_t name_hash = hash(name);
+        const size_t slot = findSlot(name, name_hash);
+        if (slots_[slot] != 0) {
+            return Symbol {slots_[slot] - 1};
+        }
+
+        const auto id = static_cast<uint32_t>(names_.size());
+        names_.push_back(arena_.copy(name));
+        hashes_.push_back(name_hash);
+        slots_[slot] = id + 1;
+        return Symbol {id};
+    }
+
+    [[nodiscard]] std::optional<Symbol> find(const std::string_view name) const noexcept {
+        const size_t slot = findSlot(name, hash(name));
+        return slots_[slot] != 0 ? std::optional {Symbol {slots_[slot] - 1}} : std::nullopt;
+    }
+
+    [[nodiscard]] std::string_view name(const Symbol symbol) const noexcept {
+        return names_[symbol.id];
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return names_.size();
+    }
+};
+
+} // namespace skarn::ast
+
+template <>
+struct std::hash<skarn::ast::Symbol> {
+    size_t operator()(const skarn::ast::Symbol symbol) const noexcept {
+        return std::hash<uint32_t> {}(symbol.id);
+    }
+};
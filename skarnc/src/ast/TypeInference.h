@@ -0,0 +1,251 @@
+#pragma once
+
+#include "Unit.h"
+#include <format>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace skarn::ast {
+
+/// Infers the types of a unit resolved with resolve_slots and stores them in the nodes: every expression,
+/// variable, argument and function return gets Int or Bool, the format of println is a String.
+/// Types are variables unified over the whole unit, so recursive calls need no annotations. Functions are monomorphic,
+/// a type that no use decides, e.g. of an unused argument, is Int.
+/// Arithmetic and ordering take Int, equality takes equal types, a while condition is Int or Bool.
+class TypeInference final {
+    using TypeVariable = uint32_t;
+
+    const SymbolTable& symbols_;
+    std::optional<Symbol> println_;
+    std::vector<TypeVariable> parents_; // union-find
+    std::vector<TypeKind> kinds_;       // of the roots
+    std::vector<TypeVariable> frames_;  // first variable of the slots of each function
+    std::vector<TypeVariable> returns_;
+    std::vector<size_t> argument_counts_;
+    std::vector<std::pair<TypeInfo*, TypeVariable>> nodes_;
+    Symbol function_name_;
+    TypeVariable frame_ {};
+
+    [[noreturn]] void fail(const std::string_view message) const {
+        throw std::runtime_error {std::format("{} in function '{}'", message, symbols_.name(function_name_))};
+    }
+
+    TypeVariable create(const TypeKind kind = TypeKind::Unknown) {
+        const auto variable = static_cast<TypeVariable>(parents_.size());
+        parents_.push_back(variable);
+        kinds_.push_back(kind);
+        return variable;
+    }
+
+    [[nodiscard]] TypeVariable find(TypeVariable variable) {
+        while (parents_[variable] != variable) {
+            parents_[variable] = parents_[parents_[variable]];
+            variable = parents_[variable];
+        }
+
+        return variable;
+    }
+
+    void unify(const TypeVariable expected, const TypeVariable actual) {
+        const TypeVariable lhs = find(expected);
+        const TypeVariable rhs = find(actual);
+        if (lhs == rhs) {
+            return;
+        }
+
+        if (kinds_[lhs] != TypeKind::Unknown && kinds_[rhs] != TypeKind::Unknown && kinds_[lhs] != kinds_[rhs]) {
+            fail(std::format("Type mismatch: expected {}, found {}", to_string(kinds_[lhs]), to_string(kinds_[rhs])));
+        }
+
+        if (kinds_[lhs] == TypeKind::Unknown) {
+            kinds_[lhs] = kinds_[rhs];
+        }
+
+        parents_[rhs] = lhs;
+    }
+
+    void require(const TypeVariable variable, const TypeKind kind) {
+        unify(create(kind), variable);
+    }
+
+    TypeVariable record(TypeInfo& type, const TypeVariable variable) {
+        nodes_.emplace_back(&type, variable);
+        return variable;
+    }
+
+    TypeVariable infer(Expression& expression) {
+        const TypeVariable variable = std::visit([this]<class T>(T& expr) -> TypeVariable {
+            if constexpr (std::is_same_v<T, ConstantExpression>) {
+                return create(TypeKind::Int);
+            }
+            else if constexpr (std::is_same_v<T, VariableExpression>) {
+                return frame_ + expr.slot;
+            }
+            else if constexpr (std::is_same_v<T, UnaryExpression>) {
+                const TypeVariable arg = infer(*expr.arg);
+                require(arg, TypeKind::Int);
+                return arg;
+            }
+            else if constexpr (std::is_same_v<T, BinaryExpression>) {
+                TypeVariable result = infer(expr.args[0]);
+                for (size_t i = 1; i < expr.args.size(); ++i) {
+                    result = binary(expr.op, result, infer(expr.args[i]));
+                }
+
+                return result;
+            }
+            else if constexpr (std::is_same_v<T, FunctionCallExpression>) {
+                return call(expr);
+            }
+            else {
+                fail(std::format("String \"{}\" is not a value", symbols_.name(expr.value)));
+            }
+        }, expression.value);
+
+        return record(expression.type, variable);
+    }
+
+    TypeVariable binary(const BinaryOp op, const TypeVariable lhs, const TypeVariable rhs) {
+        switch (op) {
+            case BinaryOp::Add:
+            case BinaryOp::Subtract:
+            case BinaryOp::Multiply:
+            case BinaryOp::Divide:
+                require(lhs, TypeKind::Int);
+                require(rhs, TypeKind::Int);
+                return lhs;
+            case BinaryOp::Equal:
+            case BinaryOp::NotEqual:
+                unify(lhs, rhs);
+                return create(TypeKind::Bool);
+            case BinaryOp::LessThan:
+            case BinaryOp::LessThanOrEqual:
+            case BinaryOp::GreaterThan:
+            case BinaryOp::GreaterThanOrEqual:
+                require(lhs, TypeKind::Int);
+                require(rhs, TypeKind::Int);
+                return create(TypeKind::Bool);
+        }
+
+        throw std::logic_error {"Unknown binary operator"};
+    }
+
+    TypeVariable call(FunctionCallExpression& expr) {
+        if (expr.callee == unresolved_index) {
+            if (expr.name != println_) {
+                fail(std::format("Unknown function '{}'", symbols_.name(expr.name)));
+            }
+
+            if (expr.args.empty() || !std::holds_alternative<StringExpression>(expr.args[0].value)) {
+                fail("println expects a format string");
+            }
+
+            record(expr.args[0].type, create(TypeKind::String));
+            for (Expression& arg : expr.args.subspan(1)) {
+                infer(arg);
+            }
+
+            return create(TypeKind::Int);
+        }
+
+        if (expr.args.size() != argument_counts_[expr.callee]) {
+            fail(std::format("Function '{}' takes {} arguments", symbols_.name(expr.name), argument_counts_[expr.callee]));
+        }
+
+        for (size_t i = 0; i < expr.args.size(); ++i) {
+            unify(frames_[expr.callee] + static_cast<TypeVariable>(i), infer(expr.args[i]));
+        }
+
+        return returns_[expr.callee];
+    }
+
+    void infer(Statement& statement, const TypeVariable result) {
+        std::visit([this, result]<class T>(T& stmt) {
+            if constexpr (std::is_same_v<T, VariableDeclarationStatement>) {
+                unify(frame_ + stmt.slot, infer(stmt.initializer));
+                record(stmt.type, frame_ + stmt.slot);
+            }
+            else if constexpr (std::is_same_v<T, VariableAssignmentStatement>) {
+                unify(frame_ + stmt.slot, infer(stmt.expression));
+                record(stmt.type, frame_ + stmt.slot);
+            }
+            else if constexpr (std::is_same_v<T, WhileStatement>) {
+                infer(stmt.condition); // Int or Bool, the other types are not values
+                for (Statement& child : stmt.statements) {
+                    infer(child, result);
+                }
+            }
+            else if constexpr (std::is_same_v<T, ReturnStatement>) {
+                unify(result, infer(stmt.expression));
+            }
+            else {
+                infer(stmt.expression);
+            }
+        }, statement.value);
+    }
+
+    void infer(Function& function, const size_t index) {
+        function_name_ = function.name;
+        frame_ = frames_[index];
+        const TypeVariable result = returns_[index];
+
+        for (Statement& statement : function.statements) {
+            infer(statement, result);
+        }
+
+        if (function.lastExpression) {
+            unify(result, infer(*function.lastExpression));
+        }
+        else if (function.statements.empty() || !std::holds_alternative<ReturnStatement>(function.statements.back().value)) {
+            require(result, TypeKind::Int); // falls through and returns 0
+        }
+
+        for (uint32_t i = 0; i != function.arguments.size(); ++i) {
+            record(function.arguments[i].type, frame_ + i);
+        }
+
+        record(function.returnType, result);
+    }
+
+public:
+    explicit TypeInference(const Unit& unit)
+        : symbols_ {unit.symbols}
+        , println_ {unit.symbols.find("println")} {
+    }
+
+    void infer(Unit& unit) {
+        frames_.clear();
+        returns_.clear();
+        argument_counts_.clear();
+        for (const Function& function : unit.functions) {
+            frames_.push_back(static_cast<TypeVariable>(parents_.size()));
+            argument_counts_.push_back(function.arguments.size());
+            for (uint32_t slot = 0; slot != function.slotCount; ++slot) {
+                create();
+            }
+        }
+
+        for (size_t i = 0; i < unit.functions.size(); ++i) {
+            returns_.push_back(create());
+        }
+
+        for (size_t i = 0; i < unit.functions.size(); ++i) {
+            infer(unit.functions[i], i);
+        }
+
+        for (const auto& [type, variable] : nodes_) {
+            const TypeKind kind = kinds_[find(variable)];
+            type->kind = kind == TypeKind::Unknown ? TypeKind::Int : kind;
+        }
+
+        nodes_.clear();
+    }
+};
+
+inline void infer_types(Unit& unit) {
+    TypeInference {unit}.infer(unit);
+}
+
+} // namespace skarn::ast
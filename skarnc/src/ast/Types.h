@@ -1,15 +1,34 @@
 #pragma once
 
+#include <string_view>
+
 namespace skarn::ast {
 
 enum class TypeKind {
     Unknown,
     Int,
     Bool,
+    String,
 };
 
 struct TypeInfo {
     TypeKind kind {TypeKind::Unknown};
+
+    constexpr bool operator ==(const TypeInfo&) const noexcept = default;
 };
 
+constexpr std::string_view to_string(const TypeKind kind) noexcept {
+    using namespace std::string_view_literals;
+    switch (kind) {
+        case TypeKind::Int:
+            return "Int"sv;
+        case TypeKind::Bool:
+            return "Bool"sv;
+        case TypeKind::String:
+            return "String"sv;
+        default:
+            return "Unknown"sv;
+    }
+}
+
 } // namespace skarn::ast
@@ -1,12 +1,18 @@
 #pragma once
 
 #include "Function.h"
+#include <string>
+#include <vector>
 
 namespace skarn::ast {
 
+/// Unit owns the storage its nodes refer to: names are symbols of the table, expression nodes live in the arena.
+/// The parser writes into the table and the arena attached to the parser context, which are then moved into the unit.
 struct Unit {
     std::string unitName;
     std::vector<Function> functions;
+    SymbolTable symbols;
+    Arena arena;
 };
 
 } // namespace skarn::ast
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace skarn::bytecode {
+
+using Value = int64_t;
+
+/// Operations of the register machine. Operands a, b, c are registers of the frame unless noted.
+enum class OpCode : uint8_t {
+    LoadInt,            // a = b | c << 16
+    Move,               // a = b
+    Negate,             // a = -b
+    Add,                // a = b + c
+    Subtract,           // a = b - c
+    Multiply,           // a = b * c
+    Divide,             // a = b / c
+    Equal,              // a = b == c
+    NotEqual,           // a = b != c
+    LessThan,           // a = b < c
+    LessThanOrEqual,    // a = b <= c
+    GreaterThan,        // a = b > c
+    GreaterThanOrEqual, // a = b >= c
+    Jump,               // jump to the instruction b
+    JumpIfFalse,        // if a == 0 jump to the instruction b
+    Call,               // a = call function b, the arguments are in registers starting at c
+    Println,            // print the string a formatted with c registers starting at b
+    Return,             // return a
+};
+
+inline constexpr size_t op_code_count = static_cast<size_t>(OpCode::Return) + 1;
+
+/// Fixed-width instruction.
+struct Instruction {
+    OpCode op;
+    uint16_t a;
+    uint16_t b;
+    uint16_t c;
+
+    [[nodiscard]] constexpr int32_t immediate() const noexcept {
+        return static_cast<int32_t>(static_cast<uint32_t>(b) | static_cast<uint32_t>(c) << 16);
+    }
+};
+
+static_assert(sizeof(Instruction) == 8);
+
+struct CompiledFunction {
+    std::string name;
+    uint16_t argument_count;
+    uint16_t register_count; // arguments occupy the first registers, the variables and temporaries follow
+    std::vector<Instruction> code;
+};
+
+struct Program {
+    std::vector<CompiledFunction> functions;
+    std::vector<std::string> strings;
+};
+
+} // namespace skarn::bytecode
@@ -0,0 +1,299 @@
+#pragma once
+
+#include "Bytecode.h"
+#include "ThreadPool.h"
+#include "ast/Unit.h"
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace skarn::bytecode {
+
+/// Compiles a unit resolved with ast::resolve_slots to bytecode.
+/// The variables of a function are its first registers, temporaries are allocated above them as a stack.
+class Compiler final {
+    const ast::Unit& unit_;
+    std::vector<std::string>* strings_ {};
+    CompiledFunction* function_ {};
+    size_t variable_count_ {};
+    size_t next_register_ {};
+    std::optional<ast::Symbol> println_;
+
+    static constexpr size_t max_index = std::numeric_limits<uint16_t>::max();
+
+    [[nodiscard]] static uint16_t checked(const size_t value, const std::string_view what) {
+        if (value > max_index) {
+            throw std::runtime_error {std::format("Too many {} in a function", what)};
+        }
+
+        return static_cast<uint16_t>(value);
+    }
+
+    size_t emit(const OpCode op, const uint16_t a = 0, const uint16_t b = 0, const uint16_t c = 0) {
+        function_->code.push_back(Instruction {op, a, b, c});
+        std::ignore = checked(function_->code.size(), "instructions");
+        return function_->code.size() - 1;
+    }
+
+    [[nodiscard]] uint16_t here() const {
+        return static_cast<uint16_t>(function_->code.size());
+    }
+
+    uint16_t allocate(const size_t count = 1) {
+        const size_t first = next_register_;
+        next_register_ += count;
+        function_->register_count = std::max(function_->register_count, checked(next_register_, "registers"));
+        return static_cast<uint16_t>(first);
+    }
+
+    /// Returns the register holding the value, variables are used in place.
+    uint16_t compileOperand(const ast::Expression& expression) {
+        if (const auto* variable = std::get_if<ast::VariableExpression>(&expression.value)) {
+            return static_cast<uint16_t>(variable->slot);
+        }
+
+        const uint16_t result = allocate();
+        compileInto(expression, result);
+        return result;
+    }
+
+    /// Stores the value into the register, operands are read before the register is written.
+    void compileInto(const ast::Expression& expression, const uint16_t target) {
+        const size_t mark = next_register_;
+        std::visit([this, target]<class T>(const T& expr) {
+            if constexpr (std::is_same_v<T, ast::ConstantExpression>) {
+                const auto value = static_cast<uint32_t>(expr.value);
+                emit(OpCode::LoadInt, target, static_cast<uint16_t>(value), static_cast<uint16_t>(value >> 16));
+            }
+            else if constexpr (std::is_same_v<T, ast::VariableExpression>) {
+                if (expr.slot != target) {
+                    emit(OpCode::Move, target, static_cast<uint16_t>(expr.slot));
+                }
+            }
+            else if constexpr (std::is_same_v<T, ast::UnaryExpression>) {
+                const uint16_t arg = compileOperand(*expr.arg);
+                emit(expr.op == ast::UnaryOp::Minus ? OpCode::Negate : OpCode::Move, target, arg);
+            }
+            else if constexpr (std::is_same_v<T, ast::BinaryExpression>) {
+                const OpCode op = binaryOp(expr.op);
+                // a chain accumulates in a temporary, the target may be read by the operands
+                const uint16_t accumulator = expr.args.size() > 2 ? allocate() : target;
+                const uint16_t first = compileOperand(expr.args[0]);
+                emit(op, accumulator, first, compileOperand(expr.args[1]));
+                for (size_t i = 2; i < expr.args.size(); ++i) {
+                    emit(op, accumulator, accumulator, compileOperand(expr.args[i]));
+                }
+
+                if (accumulator != target) {
+                    emit(OpCode::Move, target, accumulator);
+                }
+            }
+            else if constexpr (std::is_same_v<T, ast::FunctionCallExpression>) {
+                compileCall(expr, target);
+            }
+            else {
+                throw std::runtime_error {std::format("String \"{}\" is not a value", unit_.symbols.name(expr.value))};
+            }
+        }, expression.value);
+
+        next_register_ = mark;
+    }
+
+    void compileCall(const ast::FunctionCallExpression& expr, const uint16_t target) {
+        if (expr.callee == ast::unresolved_index) {
+            if (expr.name != println_) {
+                throw std::runtime_error {std::format("Unknown function '{}'", unit_.symbols.name(expr.name))};
+            }
+
+            if (expr.args.empty() || !std::holds_alternative<ast::StringExpression>(expr.args[0].value)) {
+                throw std::runtime_error {"println expects a format string"};
+            }
+
+            const auto args = expr.args.subspan(1);
+            const uint16_t first = allocate(args.size());
+            for (size_t i = 0; i < args.size(); ++i) {
+                compileInto(args[i], static_cast<uint16_t>(first + i));
+            }
+
+            strings_->emplace_back(unit_.symbols.name(std::get<ast::StringExpression>(expr.args[0].value).value));
+            emit(OpCode::Println, checked(strings_->size() - 1, "strings"), first, static_cast<uint16_t>(args.size()));
+            emit(OpCode::LoadInt, target);
+            return;
+        }
+
+        const ast::Function& callee = unit_.functions[expr.callee];
+        if (expr.args.size() != callee.arguments.size()) {
+            throw std::runtime_error {std::format("Function '{}' takes {} arguments",
+                unit_.symbols.name(callee.name), callee.arguments.size())};
+        }
+
+        // the arguments become the first registers of the callee frame, which may start at the target
+        // if it is the topmost temporary: the result is written after the callee frame is gone.
+        // A frame never starts at the register 0 of the caller, so each call moves the base forward
+        if (target >= variable_count_ && target + 1U == next_register_ && target != 0) {
+            --next_register_;
+        }
+
+        const uint16_t first = allocate(expr.args.size());
+        for (size_t i = 0; i < expr.args.size(); ++i) {
+            compileInto(expr.args[i], static_cast<uint16_t>(first + i));
+        }
+
+        emit(OpCode::Call, target, checked(expr.callee, "functions"), first);
+    }
+
+    void compile(const ast::Statement& statement) {
+        const size_t mark = next_register_;
+        std::visit([this, mark]<class T>(const T& stmt) {
+            if constexpr (std::is_same_v<T, ast::VariableDeclarationStatement>) {
+                compileInto(stmt.initializer, static_cast<uint16_t>(stmt.slot));
+            }
+            else if constexpr (std::is_same_v<T, ast::VariableAssignmentStatement>) {
+                compileInto(stmt.expression, static_cast<uint16_t>(stmt.slot));
+            }
+            else if constexpr (std::is_same_v<T, ast::WhileStatement>) {
+                const uint16_t start = here();
+                const size_t exit = emit(OpCode::JumpIfFalse, compileOperand(stmt.condition));
+                next_register_ = mark; // the condition is not used by the body
+                for (const ast::Statement& child : stmt.statements) {
+                    compile(child);
+                }
+
+                emit(OpCode::Jump, 0, start);
+                function_->code[exit].b = here();
+            }
+            else if constexpr (std::is_same_v<T, ast::ReturnStatement>) {
+                emit(OpCode::Return, compileOperand(stmt.expression));
+            }
+            else {
+                compileInto(stmt.expression, allocate());
+            }
+        }, statement.value);
+
+        next_register_ = mark;
+    }
+
+    void compile(const ast::Function& function) {
+        next_register_ = 0;
+        variable_count_ = function.slotCount;
+        std::ignore = allocate(function.slotCount);
+
+        for (const ast::Statement& statement : function.statements) {
+            compile(statement);
+        }
+
+        if (function.lastExpression) {
+            emit(OpCode::Return, compileOperand(*function.lastExpression));
+        }
+        else {
+            const uint16_t result = allocate();
+            emit(OpCode::LoadInt, result);
+            emit(OpCode::Return, result);
+        }
+    }
+
+    [[nodiscard]] static OpCode binaryOp(const ast::BinaryOp op) {
+        switch (op) {
+            case ast::BinaryOp::Add:
+                return OpCode::Add;
+            case ast::BinaryOp::Subtract:
+                return OpCode::Subtract;
+            case ast::BinaryOp::Multiply:
+                return OpCode::Multiply;
+            case ast::BinaryOp::Divide:
+                return OpCode::Divide;
+            case ast::BinaryOp::Equal:
+                return OpCode::Equal;
+            case ast::BinaryOp::NotEqual:
+                return OpCode::NotEqual;
+            case ast::BinaryOp::LessThan:
+                return OpCode::LessThan;
+            case ast::BinaryOp::LessThanOrEqual:
+                return OpCode::LessThanOrEqual;
+            case ast::BinaryOp::GreaterThan:
+                return OpCode::GreaterThan;
+            case ast::BinaryOp::GreaterThanOrEqual:
+                return OpCode::GreaterThanOrEqual;
+        }
+
+        throw std::logic_error {"Unknown binary operator"};
+    }
+
+public:
+    explicit Compiler(const ast::Unit& unit)
+        : unit_ {unit}
+        , println_ {unit.symbols.find("println")} {
+    }
+
+    /// Compiles a function, the strings it prints are appended to strings and numbered by their position there.
+    [[nodiscard]] CompiledFunction compile(const ast::Function& function, std::vector<std::string>& strings) {
+        CompiledFunction result {
+            .name = std::string {unit_.symbols.name(function.name)},
+            .argument_count = checked(function.arguments.size(), "arguments"),
+            .register_count = 0,
+            .code = {},
+        };
+
+        function_ = &result;
+        strings_ = &strings;
+        compile(function);
+        function_ = nullptr;
+        return result;
+    }
+
+    [[nodiscard]] Program compile() && {
+        Program program;
+        program.functions.reserve(unit_.functions.size());
+        for (const ast::Function& function : unit_.functions) {
+            program.functions.push_back(compile(function, program.strings));
+        }
+
+        return program;
+    }
+
+    /// Renumbers the strings of a function compiled with its own strings, which are appended after offset others.
+    static void relocate_strings(CompiledFunction& function, const size_t offset) {
+        for (Instruction& instruction : function.code) {
+            if (instruction.op == OpCode::Println) {
+                instruction.a = checked(instruction.a + offset, "strings");
+            }
+        }
+    }
+};
+
+inline Program compile(const ast::Unit& unit) {
+    return Compiler {unit}.compile();
+}
+
+/// Compiles the functions on the pool, the program is the same as the one compiled by a single thread.
+inline Program compile(const ast::Unit& unit, ThreadPool& pool) {
+    const size_t count = unit.functions.size();
+    std::vector<CompiledFunction> functions(count);
+    std::vector<std::vector<std::string>> strings(count);
+    std::vector<std::optional<Compiler>> compilers(pool.thread_count());
+    pool.parallel_for(count, [&](const size_t index, const size_t worker) {
+        std::optional<Compiler>& compiler = compilers[worker];
+        if (!compiler) {
+            compiler.emplace(unit);
+        }
+
+        functions[index] = compiler->compile(unit.functions[index], strings[index]);
+    });
+
+    Program program {.functions = std::move(functions), .strings = {}};
+    for (size_t index = 0; index < count; ++index) {
+        if (!strings[index].empty()) {
+            Compiler::relocate_strings(program.functions[index], program.strings.size());
+            std::ranges::move(strings[index], std::back_inserter(program.strings));
+        }
+    }
+
+    return program;
+}
+
+} // namespace skarn::bytecode
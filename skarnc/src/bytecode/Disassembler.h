@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Bytecode.h"
+#include <array>
+#include <format>
+#include <string>
+#include <string_view>
+
+namespace skarn::bytecode {
+
+[[nodiscard]] constexpr std::string_view to_string(const OpCode op) noexcept {
+    constexpr std::array<std::string_view, op_code_count> names {
+        "load_int", "move", "negate", "add", "subtract", "multiply", "divide",
+        "equal", "not_equal", "less_than", "less_than_or_equal", "greater_than", "greater_than_or_equal",
+        "jump", "jump_if_false", "call", "println", "return",
+    };
+
+    return names[static_cast<size_t>(op)];
+}
+
+[[nodiscard]] inline std::string to_string(const Program& program, const Instruction& instruction) {
+    const std::string_view name = to_string(instruction.op);
+    switch (instruction.op) {
+        case OpCode::LoadInt:
+            return std::format("{} r{}, {}", name, instruction.a, instruction.immediate());
+        case OpCode::Move:
+        case OpCode::Negate:
+            return std::format("{} r{}, r{}", name, instruction.a, instruction.b);
+        case OpCode::Jump:
+            return std::format("{} @{}", name, instruction.b);
+        case OpCode::JumpIfFalse:
+            return std::format("{} r{}, @{}", name, instruction.a, instruction.b);
+        case OpCode::Call:
+            return std::format("{} r{}, {}, r{}", name, instruction.a, program.functions[instruction.b].name, instruction.c);
+        case OpCode::Println:
+            return std::format("{} \"{}\", r{}, {}", name, program.strings[instruction.a], instruction.b, instruction.c);
+        case OpCode::Return:
+            return std::format("{} r{}", name, instruction.a);
+        default:
+            return std::format("{} r{}, r{}, r{}", name, instruction.a, instruction.b, instruction.c);
+    }
+}
+
+/// Listing of the program, one function header followed by its numbered instructions.
+[[nodiscard]] inline std::string disassemble(const Program& program) {
+    std::string result;
+    for (const CompiledFunction& function : program.functions) {
+        result += std::format("fn {}: {} arguments, {} registers\n", function.name, function.argument_count, function.register_count);
+        for (size_t i = 0; i < function.code.size(); ++i) {
+            result += std::format("{:4}: {}\n", i, to_string(program, function.code[i]));
+        }
+    }
+
+    return result;
+}
+
+} // namespace skarn::bytecode
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "Arithmetic.h"
+#include "Bytecode.h"
+#include "CallLimits.h"
+#include <algorithm>
+#include <format>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__GNUC__)
+#define SKARN_VM_COMPUTED_GOTO 1
+#endif
+
+namespace skarn::bytecode {
+
+/// Register machine running a compiled program.
+/// A frame is a window of the register file, the callee window starts at the argument registers of the caller,
+/// so arguments are passed without copies. Calls do not recurse on the native stack, their depth is bounded
+/// by the same limits as in the interpreter.
+class Vm final {
+    struct Frame {
+        const CompiledFunction* function;
+        const Instruction* return_ip;
+        size_t base;
+        uint16_t target; // register of the caller receiving the result
+    };
+
+    const Program& program_;
+    std::ostream& out_;
+    std::vector<Value> registers_;
+    std::vector<Frame> frames_;
+    size_t max_depth_;
+
+    void println(const std::string_view format, const Value* args, const size_t count) {
+        std::string line;
+        size_t arg = 0;
+        for (size_t i = 0; i < format.size(); ++i) {
+            if (format.substr(i, 2) == "{}") {
+                if (arg == count) {
+                    throw std::runtime_error {"println has not enough arguments"};
+                }
+
+                line += std::to_string(args[arg++]);
+                ++i;
+            }
+            else if (format.substr(i, 2) == "{{" || format.substr(i, 2) == "}}") {
+                line += format[i++];
+            }
+            else {
+                line += format[i];
+            }
+        }
+
+        out_ << line << '\n';
+    }
+
+    /// The compiler starts a callee frame at least one register above its caller, this bounds the recursion depth
+    /// by the register file.
+    void checkFrame(const size_t base, const CompiledFunction& function) const {
+        if (base + std::max<size_t>(function.register_count, 1) > registers_.size()) {
+            throw std::runtime_error {"Stack overflow"};
+        }
+    }
+
+    [[nodiscard]] Value execute(const CompiledFunction& entry, const size_t entry_base) {
+        frames_.clear(); // left over if the previous call threw
+        frames_.push_back(Frame {&entry, nullptr, entry_base, 0});
+
+        const CompiledFunction* function = &entry;
+        const Instruction* ip = entry.code.data();
+        Value* r = registers_.data() + entry_base;
+        const Instruction* instruction {};
+
+#ifdef SKARN_VM_COMPUTED_GOTO
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+        // one indirect jump per handler, the order follows OpCode
+        static void* const labels[] {
+            &&LoadInt, &&Move, &&Negate, &&Add, &&Subtract, &&Multiply, &&Divide,
+            &&Equal, &&NotEqual, &&LessThan, &&LessThanOrEqual, &&GreaterThan, &&GreaterThanOrEqual,
+            &&Jump, &&JumpIfFalse, &&Call, &&Println, &&Return,
+        };
+        static_assert(std::size(labels) == op_code_count);
+
+#define SKARN_VM_CASE(name) name
+#define SKARN_VM_NEXT() do { instruction = ip++; goto *labels[static_cast<size_t>(instruction->op)]; } while (false)
+        SKARN_VM_NEXT();
+#else
+#define SKARN_VM_CASE(name) case OpCode::name
+#define SKARN_VM_NEXT() continue
+        for (;;) {
+            instruction = ip++;
+            switch (instruction->op) {
+#endif
+        SKARN_VM_CASE(LoadInt):
+            r[instruction->a] = instruction->immediate();
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(Move):
+            r[instruction->a] = r[instruction->b];
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(Negate):
+            r[instruction->a] = wrapping_negate(r[instruction->b]);
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(Add):
+            r[instruction->a] = wrapping_add(r[instruction->b], r[instruction->c]);
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(Subtract):
+            r[instruction->a] = wrapping_subtract(r[instruction->b], r[instruction->c]);
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(Multiply):
+            r[instruction->a] = wrapping_multiply(r[instruction->b], r[instruction->c]);
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(Divide):
+            r[instruction->a] = wrapping_divide(r[instruction->b], r[instruction->c]);
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(Equal):
+            r[instruction->a] = r[instruction->b] == r[instruction->c];
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(NotEqual):
+            r[instruction->a] = r[instruction->b] != r[instruction->c];
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(LessThan):
+            r[instruction->a] = r[instruction->b] < r[instruction->c];
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(LessThanOrEqual):
+            r[instruction->a] = r[instruction->b] <= r[instruction->c];
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(GreaterThan):
+            r[instruction->a] = r[instruction->b] > r[instruction->c];
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(GreaterThanOrEqual):
+            r[instruction->a] = r[instruction->b] >= r[instruction->c];
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(Jump):
+            ip = function->code.data() + instruction->b;
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(JumpIfFalse):
+            if (r[instruction->a] == 0) {
+                ip = function->code.data() + instruction->b;
+            }
+
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(Call): {
+            const CompiledFunction& callee = program_.functions[instruction->b];
+            const size_t base = frames_.back().base + instruction->c;
+            checkFrame(base, callee);
+            if (frames_.size() == max_depth_) {
+                throw std::runtime_error {"Stack overflow"};
+            }
+
+            frames_.push_back(Frame {&callee, ip, base, instruction->a});
+            function = &callee;
+            ip = callee.code.data();
+            r = registers_.data() + base;
+            SKARN_VM_NEXT();
+        }
+        SKARN_VM_CASE(Println):
+            println(program_.strings[instruction->a], r + instruction->b, instruction->c);
+            SKARN_VM_NEXT();
+        SKARN_VM_CASE(Return): {
+            const Value result = r[instruction->a];
+            const Frame frame = frames_.back();
+            frames_.pop_back();
+            if (frames_.empty()) {
+                return result;
+            }
+
+            function = frames_.back().function;
+            ip = frame.return_ip;
+            r = registers_.data() + frames_.back().base;
+            r[frame.target] = result;
+            SKARN_VM_NEXT();
+        }
+#ifdef SKARN_VM_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#else
+            }
+        }
+#endif
+#undef SKARN_VM_CASE
+#undef SKARN_VM_NEXT
+    }
+
+public:
+    static constexpr size_t default_register_count = 1024 * 1024;
+
+    explicit Vm(const Program& program, std::ostream& out, const size_t register_count = default_register_count,
+        const CallLimits limits = {})
+        : program_ {program}
+        , out_ {out}
+        , registers_(register_count)
+        , max_depth_ {limits.max_depth()} {
+    }
+
+    /// Calls a function of the program by name.
+    Value call(const std::string_view name, const std::span<const Value> args = {}) {
+        const auto function = std::ranges::find(program_.functions, name, &CompiledFunction::name);
+        if (function == program_.functions.end()) {
+            throw std::runtime_error {std::format("Unknown function '{}'", name)};
+        }
+
+        if (args.size() != function->argument_count) {
+            throw std::runtime_error {std::format("Function '{}' takes {} arguments", name, function->argument_count)};
+        }
+
+        checkFrame(0, *function);
+        std::ranges::copy(args, registers_.begin());
+        return execute(*function, 0);
+    }
+
+    /// Runs the main function, the result is its value.
+    Value run() {
+        return call("main");
+    }
+};
+
+} // namespace skarn::bytecode
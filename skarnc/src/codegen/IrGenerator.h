@@ -0,0 +1,278 @@
+#pragma once
+
+#include "Runtime.h"
+#include "ast/Unit.h"
+#include <format>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/raw_ostream.h>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace skarn::codegen {
+
+/// Generates an LLVM module from a unit resolved with ast::resolve_slots.
+/// Values are i64, a function of the unit takes and returns i64 and is named by function_symbol.
+/// Variables are allocas of the entry block, the optimizer promotes them to registers.
+class IrGenerator final {
+    const ast::Unit& unit_;
+    llvm::LLVMContext& context_;
+    std::unique_ptr<llvm::Module> module_;
+    llvm::IRBuilder<> builder_;
+    llvm::Type* value_type_;
+    std::vector<llvm::Function*> functions_;
+    std::vector<llvm::AllocaInst*> slots_;
+    llvm::Function* function_ {};
+    llvm::FunctionCallee println_function_;
+    llvm::FunctionCallee panic_function_;
+    llvm::GlobalVariable* context_variable_;
+    std::optional<ast::Symbol> println_;
+
+    [[nodiscard]] llvm::Value* constant(const int64_t value) const {
+        return llvm::ConstantInt::get(value_type_, value, true);
+    }
+
+    [[nodiscard]] llvm::BasicBlock* createBlock(const std::string_view name) const {
+        return llvm::BasicBlock::Create(context_, name, function_);
+    }
+
+    [[nodiscard]] llvm::Value* divide(llvm::Value* lhs, llvm::Value* rhs) {
+        llvm::BasicBlock* fail = createBlock("division_by_zero");
+        llvm::BasicBlock* next = createBlock("divide");
+        builder_.CreateCondBr(builder_.CreateICmpEQ(rhs, constant(0)), fail, next);
+
+        builder_.SetInsertPoint(fail);
+        builder_.CreateCall(panic_function_, {builder_.CreateGlobalString("Division by zero")});
+        builder_.CreateUnreachable();
+
+        // sdiv traps on INT64_MIN / -1, the division by -1 is a wrapping negation as in the other engines
+        builder_.SetInsertPoint(next);
+        llvm::Value* negative_one = builder_.CreateICmpEQ(rhs, constant(-1));
+        llvm::Value* quotient = builder_.CreateSDiv(lhs, builder_.CreateSelect(negative_one, constant(1), rhs));
+        return builder_.CreateSelect(negative_one, builder_.CreateNeg(lhs), quotient);
+    }
+
+    [[nodiscard]] llvm::Value* binary(const ast::BinaryOp op, llvm::Value* lhs, llvm::Value* rhs) {
+        const auto compare = [this, lhs, rhs](const llvm::CmpInst::Predicate predicate) {
+            return builder_.CreateZExt(builder_.CreateICmp(predicate, lhs, rhs), value_type_);
+        };
+
+        switch (op) {
+            case ast::BinaryOp::Add:
+                return builder_.CreateAdd(lhs, rhs);
+            case ast::BinaryOp::Subtract:
+                return builder_.CreateSub(lhs, rhs);
+            case ast::BinaryOp::Multiply:
+                return builder_.CreateMul(lhs, rhs);
+            case ast::BinaryOp::Divide:
+                return divide(lhs, rhs);
+            case ast::BinaryOp::Equal:
+                return compare(llvm::CmpInst::ICMP_EQ);
+            case ast::BinaryOp::NotEqual:
+                return compare(llvm::CmpInst::ICMP_NE);
+            case ast::BinaryOp::LessThan:
+                return compare(llvm::CmpInst::ICMP_SLT);
+            case ast::BinaryOp::LessThanOrEqual:
+                return compare(llvm::CmpInst::ICMP_SLE);
+            case ast::BinaryOp::GreaterThan:
+                return compare(llvm::CmpInst::ICMP_SGT);
+            case ast::BinaryOp::GreaterThanOrEqual:
+                return compare(llvm::CmpInst::ICMP_SGE);
+        }
+
+        throw std::logic_error {"Unknown binary operator"};
+    }
+
+    [[nodiscard]] llvm::Value* generate(const ast::Expression& expression) {
+        return std::visit([this]<class T>(const T& expr) -> llvm::Value* {
+            if constexpr (std::is_same_v<T, ast::ConstantExpression>) {
+                return constant(expr.value);
+            }
+            else if constexpr (std::is_same_v<T, ast::VariableExpression>) {
+                return builder_.CreateLoad(value_type_, slots_[expr.slot]);
+            }
+            else if constexpr (std::is_same_v<T, ast::UnaryExpression>) {
+                llvm::Value* value = generate(*expr.arg);
+                return expr.op == ast::UnaryOp::Minus ? builder_.CreateNeg(value) : value;
+            }
+            else if constexpr (std::is_same_v<T, ast::BinaryExpression>) {
+                llvm::Value* result = generate(expr.args[0]);
+                for (size_t i = 1; i < expr.args.size(); ++i) {
+                    result = binary(expr.op, result, generate(expr.args[i]));
+                }
+
+                return result;
+            }
+            else if constexpr (std::is_same_v<T, ast::FunctionCallExpression>) {
+                return call(expr);
+            }
+            else {
+                throw std::runtime_error {std::format("String \"{}\" is not a value", unit_.symbols.name(expr.value))};
+            }
+        }, expression.value);
+    }
+
+    [[nodiscard]] llvm::Value* call(const ast::FunctionCallExpression& expr) {
+        if (expr.callee == ast::unresolved_index) {
+            if (expr.name != println_) {
+                throw std::runtime_error {std::format("Unknown function '{}'", unit_.symbols.name(expr.name))};
+            }
+
+            println(expr.args);
+            return constant(0);
+        }
+
+        const ast::Function& callee = unit_.functions[expr.callee];
+        if (expr.args.size() != callee.arguments.size()) {
+            throw std::runtime_error {std::format("Function '{}' takes {} arguments",
+                unit_.symbols.name(callee.name), callee.arguments.size())};
+        }
+
+        std::vector<llvm::Value*> args;
+        args.reserve(expr.args.size());
+        for (const ast::Expression& arg : expr.args) {
+            args.push_back(generate(arg));
+        }
+
+        return builder_.CreateCall(functions_[expr.callee], args);
+    }
+
+    void println(const std::span<const ast::Expression> args) {
+        if (args.empty() || !std::holds_alternative<ast::StringExpression>(args[0].value)) {
+            throw std::runtime_error {"println expects a format string"};
+        }
+
+        const std::string_view format = unit_.symbols.name(std::get<ast::StringExpression>(args[0].value).value);
+        size_t placeholders = 0;
+        for (size_t i = 0; i < format.size(); ++i) {
+            if (format.substr(i, 2) == "{}") {
+                ++placeholders;
+                ++i;
+            }
+            else if (format.substr(i, 2) == "{{" || format.substr(i, 2) == "}}") {
+                ++i;
+            }
+        }
+
+        if (placeholders >= args.size()) {
+            throw std::runtime_error {"println has not enough arguments"};
+        }
+
+        // the runtime reads the arguments of the placeholders
+        std::vector<llvm::Value*> values {context_variable_, builder_.CreateGlobalString(format), constant(placeholders)};
+        for (const ast::Expression& arg : args.subspan(1)) {
+            values.push_back(generate(arg));
+        }
+
+        builder_.CreateCall(println_function_, values);
+    }
+
+    void generate(const ast::Statement& statement) {
+        std::visit([this]<class T>(const T& stmt) {
+            if constexpr (std::is_same_v<T, ast::VariableDeclarationStatement>) {
+                builder_.CreateStore(generate(stmt.initializer), slots_[stmt.slot]);
+            }
+            else if constexpr (std::is_same_v<T, ast::VariableAssignmentStatement>) {
+                builder_.CreateStore(generate(stmt.expression), slots_[stmt.slot]);
+            }
+            else if constexpr (std::is_same_v<T, ast::WhileStatement>) {
+                llvm::BasicBlock* condition = createBlock("while");
+                llvm::BasicBlock* body = createBlock("while_body");
+                llvm::BasicBlock* exit = createBlock("while_exit");
+                builder_.CreateBr(condition);
+
+                builder_.SetInsertPoint(condition);
+                builder_.CreateCondBr(builder_.CreateICmpNE(generate(stmt.condition), constant(0)), body, exit);
+
+                builder_.SetInsertPoint(body);
+                for (const ast::Statement& child : stmt.statements) {
+                    generate(child);
+                }
+
+                builder_.CreateBr(condition);
+                builder_.SetInsertPoint(exit);
+            }
+            else if constexpr (std::is_same_v<T, ast::ReturnStatement>) {
+                builder_.CreateRet(generate(stmt.expression));
+                builder_.SetInsertPoint(createBlock("after_return")); // unreachable, removed by the optimizer
+            }
+            else {
+                std::ignore = generate(stmt.expression);
+            }
+        }, statement.value);
+    }
+
+    void generate(const ast::Function& function, llvm::Function* target) {
+        function_ = target;
+        builder_.SetInsertPoint(createBlock("entry"));
+
+        slots_.clear();
+        for (uint32_t slot = 0; slot != function.slotCount; ++slot) {
+            slots_.push_back(builder_.CreateAlloca(value_type_));
+        }
+
+        for (llvm::Argument& argument : target->args()) {
+            builder_.CreateStore(&argument, slots_[argument.getArgNo()]);
+        }
+
+        for (const ast::Statement& statement : function.statements) {
+            generate(statement);
+        }
+
+        builder_.CreateRet(function.lastExpression ? generate(*function.lastExpression) : constant(0));
+    }
+
+public:
+    IrGenerator(const ast::Unit& unit, llvm::LLVMContext& context)
+        : unit_ {unit}
+        , context_ {context}
+        , module_ {std::make_unique<llvm::Module>(unit.unitName, context)}
+        , builder_ {context}
+        , value_type_ {llvm::Type::getInt64Ty(context)}
+        , println_ {unit.symbols.find("println")} {
+        llvm::Type* void_type = llvm::Type::getVoidTy(context);
+        llvm::Type* pointer_type = llvm::PointerType::getUnqual(context);
+
+        println_function_ = module_->getOrInsertFunction(println_symbol,
+            llvm::FunctionType::get(void_type, {pointer_type, pointer_type, value_type_}, true));
+        panic_function_ = module_->getOrInsertFunction(panic_symbol, llvm::FunctionType::get(void_type, {pointer_type}, false));
+        llvm::cast<llvm::Function>(panic_function_.getCallee())->setDoesNotReturn();
+
+        context_variable_ = new llvm::GlobalVariable(*module_, llvm::Type::getInt8Ty(context), true,
+            llvm::GlobalValue::ExternalLinkage, nullptr, context_symbol);
+    }
+
+    [[nodiscard]] std::unique_ptr<llvm::Module> generate() && {
+        // functions are declared first, calls may refer to the following ones
+        functions_.reserve(unit_.functions.size());
+        for (const ast::Function& function : unit_.functions) {
+            const std::vector<llvm::Type*> arguments(function.arguments.size(), value_type_);
+            functions_.push_back(llvm::Function::Create(llvm::FunctionType::get(value_type_, arguments, false),
+                llvm::GlobalValue::ExternalLinkage, function_symbol(unit_.symbols.name(function.name)), *module_));
+        }
+
+        for (size_t i = 0; i < unit_.functions.size(); ++i) {
+            generate(unit_.functions[i], functions_[i]);
+        }
+
+        std::string errors;
+        llvm::raw_string_ostream stream {errors};
+        if (llvm::verifyModule(*module_, &stream)) {
+            throw std::logic_error {std::format("Invalid module: {}", stream.str())};
+        }
+
+        return std::move(module_);
+    }
+};
+
+[[nodiscard]] inline std::unique_ptr<llvm::Module> generate_ir(const ast::Unit& unit, llvm::LLVMContext& context) {
+    return IrGenerator {unit, context}.generate();
+}
+
+} // namespace skarn::codegen
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "IrGenerator.h"
+#include "Optimizer.h"
+#include "Runtime.h"
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/Support/TargetSelect.h>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace skarn::codegen {
+
+using Value = int64_t;
+
+/// Runs a unit as native code compiled by the ORC LLJIT.
+/// The unit must be resolved with ast::resolve_slots, it is not referenced after the construction.
+class Jit final {
+    static constexpr size_t max_argument_count = 6;
+
+    struct Entry {
+        size_t argument_count;
+        llvm::orc::ExecutorAddr address; // looked up on the first call
+    };
+
+    std::unique_ptr<llvm::orc::LLJIT> jit_;
+    std::ostream& out_;
+    std::unordered_map<std::string, Entry> functions_;
+
+    template <class T>
+    static T unwrap(llvm::Expected<T> value) {
+        if (!value) {
+            throw std::runtime_error {llvm::toString(value.takeError())};
+        }
+
+        return std::move(*value);
+    }
+
+    static void check(llvm::Error error) {
+        if (error) {
+            throw std::runtime_error {llvm::toString(std::move(error))};
+        }
+    }
+
+    static void initializeTarget() {
+        static const bool initialized = [] {
+            llvm::InitializeNativeTarget();
+            llvm::InitializeNativeTargetAsmPrinter();
+            return true;
+        }();
+
+        std::ignore = initialized;
+    }
+
+    template <size_t... I>
+    static Value invoke(const llvm::orc::ExecutorAddr address, [[maybe_unused]] const std::span<const Value> args, std::index_sequence<I...>) {
+        using Function = Value (*)(decltype(I, Value {})...);
+        return address.toPtr<Function>()(args[I]...);
+    }
+
+    template <size_t... I>
+    static Value dispatch(const llvm::orc::ExecutorAddr address, const std::span<const Value> args, std::index_sequence<I...>) {
+        Value result {};
+        // selects the signature by the number of arguments
+        std::ignore = ((args.size() == I && (result = invoke(address, args, std::make_index_sequence<I> {}), true)) || ...);
+        return result;
+    }
+
+    void defineRuntime() {
+        llvm::orc::MangleAndInterner mangle {jit_->getExecutionSession(), jit_->getDataLayout()};
+        const auto symbol = [](auto* address) {
+            return llvm::orc::ExecutorSymbolDef {llvm::orc::ExecutorAddr::fromPtr(address), llvm::JITSymbolFlags::Exported};
+        };
+
+        check(jit_->getMainJITDylib().define(llvm::orc::absoluteSymbols({
+            {mangle(println_symbol), symbol(&runtime::println)},
+            {mangle(panic_symbol), symbol(&runtime::panic)},
+            {mangle(context_symbol), symbol(&out_)},
+        })));
+    }
+
+public:
+    Jit(const ast::Unit& unit, std::ostream& out, const llvm::OptimizationLevel level = llvm::OptimizationLevel::O2)
+        : out_ {out} {
+        for (const ast::Function& function : unit.functions) {
+            functions_.emplace(unit.symbols.name(function.name), Entry {function.arguments.size(), {}});
+        }
+
+        initializeTarget();
+        jit_ = unwrap(llvm::orc::LLJITBuilder {}.create());
+        defineRuntime();
+
+        auto context = std::make_unique<llvm::LLVMContext>();
+        std::unique_ptr<llvm::Module> module = generate_ir(unit, *context);
+        module->setDataLayout(jit_->getDataLayout());
+        optimize(*module, level);
+        check(jit_->addIRModule(llvm::orc::ThreadSafeModule {std::move(module), std::move(context)}));
+    }
+
+    /// Calls a function of the unit by name, the module is compiled on the first call.
+    Value call(const std::string_view name, const std::span<const Value> args = {}) {
+        const auto function = functions_.find(std::string {name});
+        if (function == functions_.end()) {
+            throw std::runtime_error {std::format("Unknown function '{}'", name)};
+        }
+
+        Entry& entry = function->second;
+        if (args.size() != entry.argument_count) {
+            throw std::runtime_error {std::format("Function '{}' takes {} arguments", name, entry.argument_count)};
+        }
+
+        if (args.size() > max_argument_count) {
+            throw std::runtime_error {std::format("Function '{}' takes more than {} arguments", name, max_argument_count)};
+        }
+
+        if (!entry.address) {
+            entry.address = unwrap(jit_->lookup(function_symbol(name)));
+        }
+
+        return dispatch(entry.address, args, std::make_index_sequence<max_argument_count + 1> {});
+    }
+
+    /// Runs the main function, the result is its value.
+    Value run() {
+        return call("main");
+    }
+};
+
+} // namespace skarn::codegen
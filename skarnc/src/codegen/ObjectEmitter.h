@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Runtime.h"
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Module.h>
+#include <llvm/MC/TargetRegistry.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Target/TargetOptions.h>
+#include <llvm/TargetParser/Host.h>
+#include <llvm/TargetParser/Triple.h>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace skarn::codegen {
+
+enum class FileType {
+    Object,
+    Assembly,
+};
+
+[[nodiscard]] inline llvm::CodeGenOptLevel to_codegen_level(const llvm::OptimizationLevel& level) noexcept {
+    switch (level.getSpeedupLevel()) {
+        case 0:
+            return llvm::CodeGenOptLevel::None;
+        case 1:
+            return llvm::CodeGenOptLevel::Less;
+        case 2:
+            return llvm::CodeGenOptLevel::Default;
+        default:
+            return llvm::CodeGenOptLevel::Aggressive;
+    }
+}
+
+/// Target machine of the host triple with the generic CPU, so the code runs on other machines of the triple.
+/// The module is configured for it.
+[[nodiscard]] inline std::unique_ptr<llvm::TargetMachine> create_target_machine(llvm::Module& module, const llvm::OptimizationLevel& level) {
+    static const bool initialized = [] {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+        return true;
+    }();
+
+    std::ignore = initialized;
+
+    const llvm::Triple triple {llvm::sys::getDefaultTargetTriple()};
+    std::string error;
+    const llvm::Target* target = llvm::TargetRegistry::lookupTarget(triple.str(), error);
+    if (target == nullptr) {
+        throw std::runtime_error {error};
+    }
+
+#if LLVM_VERSION_MAJOR >= 21
+    std::unique_ptr<llvm::TargetMachine> machine {target->createTargetMachine(triple,
+        "generic", "", llvm::TargetOptions {}, llvm::Reloc::PIC_, std::nullopt, to_codegen_level(level))};
+    module.setTargetTriple(triple);
+#else
+    std::unique_ptr<llvm::TargetMachine> machine {target->createTargetMachine(triple.str(),
+        "generic", "", llvm::TargetOptions {}, llvm::Reloc::PIC_, std::nullopt, to_codegen_level(level))};
+    module.setTargetTriple(triple.str());
+#endif
+
+    module.setDataLayout(machine->createDataLayout());
+    return machine;
+}
+
+/// Defines the C entry point if the unit has a main function, it returns the value of the function as the exit code.
+[[nodiscard]] inline bool add_entry_point(llvm::Module& module) {
+    llvm::Function* unit_main = module.getFunction(function_symbol("main"));
+    if (unit_main == nullptr) {
+        return false;
+    }
+
+    if (unit_main->arg_size() != 0) {
+        throw std::runtime_error {"Function 'main' takes arguments"};
+    }
+
+    llvm::LLVMContext& context = module.getContext();
+    llvm::Function* entry = llvm::Function::Create(llvm::FunctionType::get(llvm::Type::getInt32Ty(context), false),
+        llvm::GlobalValue::ExternalLinkage, "main", module);
+
+    llvm::IRBuilder<> builder {llvm::BasicBlock::Create(context, "entry", entry)};
+    builder.CreateRet(builder.CreateTrunc(builder.CreateCall(unit_main), builder.getInt32Ty()));
+    return true;
+}
+
+/// Generates the machine code of the module, the module must be configured by create_target_machine.
+inline void emit(llvm::Module& module, llvm::TargetMachine& machine, llvm::raw_pwrite_stream& out, const FileType type) {
+    llvm::legacy::PassManager passes;
+    const auto file_type = type == FileType::Object ? llvm::CodeGenFileType::ObjectFile : llvm::CodeGenFileType::AssemblyFile;
+    if (machine.addPassesToEmitFile(passes, out, nullptr, file_type)) {
+        throw std::runtime_error {"The target cannot emit the file type"};
+    }
+
+    passes.run(module);
+    out.flush();
+}
+
+} // namespace skarn::codegen
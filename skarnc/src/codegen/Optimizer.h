@@ -0,0 +1,30 @@
+#pragma once
+
+#include <llvm/IR/Module.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Passes/PassBuilder.h>
+
+namespace skarn::codegen {
+
+/// Runs the default pipeline of the new pass manager for the level.
+/// The target machine is optional, it enables the target specific cost models.
+inline void optimize(llvm::Module& module, const llvm::OptimizationLevel level, llvm::TargetMachine* target_machine = nullptr) {
+    llvm::LoopAnalysisManager loop_analyses;
+    llvm::FunctionAnalysisManager function_analyses;
+    llvm::CGSCCAnalysisManager cgscc_analyses;
+    llvm::ModuleAnalysisManager module_analyses;
+
+    llvm::PassBuilder builder {target_machine};
+    builder.registerModuleAnalyses(module_analyses);
+    builder.registerCGSCCAnalyses(cgscc_analyses);
+    builder.registerFunctionAnalyses(function_analyses);
+    builder.registerLoopAnalyses(loop_analyses);
+    builder.crossRegisterProxies(loop_analyses, function_analyses, cgscc_analyses, module_analyses);
+
+    llvm::ModulePassManager passes = level == llvm::OptimizationLevel::O0
+        ? builder.buildO0DefaultPipeline(level)
+        : builder.buildPerModuleDefaultPipeline(level);
+    passes.run(module, module_analyses);
+}
+
+} // namespace skarn::codegen
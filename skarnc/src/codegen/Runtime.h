@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace skarn::codegen {
+
+/// Symbols native code refers to, the host provides them. Functions of the unit are prefixed to not clash with them.
+inline constexpr std::string_view println_symbol = "skarn_println";
+inline constexpr std::string_view panic_symbol = "skarn_panic";
+inline constexpr std::string_view context_symbol = "skarn_context"; // its address is passed to println
+inline constexpr std::string_view function_prefix = "skarn.";
+
+[[nodiscard]] inline std::string function_symbol(const std::string_view name) {
+    std::string result {function_prefix};
+    result += name;
+    return result;
+}
+
+/// Runtime of the JIT, the context is the output stream.
+namespace runtime {
+
+inline void println(void* context, const char* format, const int64_t count, ...) {
+    va_list args;
+    va_start(args, count);
+
+    // the generator checks the number of arguments
+    const std::string_view text {format};
+    std::string line;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text.substr(i, 2) == "{}") {
+            line += std::to_string(va_arg(args, int64_t));
+            ++i;
+        }
+        else if (text.substr(i, 2) == "{{" || text.substr(i, 2) == "}}") {
+            line += text[i++];
+        }
+        else {
+            line += text[i];
+        }
+    }
+
+    va_end(args);
+    *static_cast<std::ostream*>(context) << line << '\n';
+}
+
+/// Native code cannot throw, errors terminate the process.
+[[noreturn]] inline void panic(const char* message) {
+    std::fprintf(stderr, "error: %s\n", message);
+    std::exit(1);
+}
+
+} // namespace runtime
+
+} // namespace skarn::codegen
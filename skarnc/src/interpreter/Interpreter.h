@@ -0,0 +1,265 @@
+#pragma once
+
+#include "Arithmetic.h"
+#include "CallLimits.h"
+#include "ast/Unit.h"
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace skarn::interpreter {
+
+using Value = int64_t;
+
+/// Tree-walking interpreter, the reference execution engine.
+/// The unit must be resolved with ast::resolve_slots: variables are accessed by frame slot and calls by function index.
+/// Frames are allocated in a stack preallocated at construction, the call depth is bounded by the limits.
+class Interpreter final {
+    enum class Flow {
+        Next,
+        Return,
+    };
+
+    const ast::Unit& unit_;
+    std::ostream& out_;
+    std::vector<Value> stack_;
+    size_t top_ {};
+    size_t depth_ {};
+    size_t max_depth_;
+    Value return_value_ {};
+    std::optional<ast::Symbol> println_;
+
+    [[nodiscard]] static Value binary(const ast::BinaryOp op, const Value lhs, const Value rhs) {
+        switch (op) {
+            case ast::BinaryOp::Add:
+                return wrapping_add(lhs, rhs);
+            case ast::BinaryOp::Subtract:
+                return wrapping_subtract(lhs, rhs);
+            case ast::BinaryOp::Multiply:
+                return wrapping_multiply(lhs, rhs);
+            case ast::BinaryOp::Divide:
+                return wrapping_divide(lhs, rhs);
+            case ast::BinaryOp::Equal:
+                return lhs == rhs;
+            case ast::BinaryOp::NotEqual:
+                return lhs != rhs;
+            case ast::BinaryOp::LessThan:
+                return lhs < rhs;
+            case ast::BinaryOp::LessThanOrEqual:
+                return lhs <= rhs;
+            case ast::BinaryOp::GreaterThan:
+                return lhs > rhs;
+            case ast::BinaryOp::GreaterThanOrEqual:
+                return lhs >= rhs;
+        }
+
+        throw std::logic_error {"Unknown binary operator"};
+    }
+
+    [[nodiscard]] Value evaluate(const ast::Expression& expression, Value* const frame) {
+        return std::visit([this, frame]<class T>(const T& expr) -> Value {
+            if constexpr (std::is_same_v<T, ast::ConstantExpression>) {
+                return expr.value;
+            }
+            else if constexpr (std::is_same_v<T, ast::VariableExpression>) {
+                return frame[expr.slot];
+            }
+            else if constexpr (std::is_same_v<T, ast::UnaryExpression>) {
+                const Value value = evaluate(*expr.arg, frame);
+                return expr.op == ast::UnaryOp::Minus ? wrapping_negate(value) : value;
+            }
+            else if constexpr (std::is_same_v<T, ast::BinaryExpression>) {
+                Value result = evaluate(expr.args[0], frame);
+                for (size_t i = 1; i < expr.args.size(); ++i) {
+                    result = binary(expr.op, result, evaluate(expr.args[i], frame));
+                }
+
+                return result;
+            }
+            else if constexpr (std::is_same_v<T, ast::FunctionCallExpression>) {
+                return call(expr, frame);
+            }
+            else {
+                throw std::runtime_error {std::format("String \"{}\" is not a value", unit_.symbols.name(expr.value))};
+            }
+        }, expression.value);
+    }
+
+    [[nodiscard]] Flow execute(const ast::Statement& statement, Value* const frame) {
+        return std::visit([this, frame]<class T>(const T& stmt) -> Flow {
+            if constexpr (std::is_same_v<T, ast::VariableDeclarationStatement>) {
+                frame[stmt.slot] = evaluate(stmt.initializer, frame);
+            }
+            else if constexpr (std::is_same_v<T, ast::VariableAssignmentStatement>) {
+                frame[stmt.slot] = evaluate(stmt.expression, frame);
+            }
+            else if constexpr (std::is_same_v<T, ast::WhileStatement>) {
+                while (evaluate(stmt.condition, frame) != 0) {
+                    if (execute(stmt.statements, frame) == Flow::Return) {
+                        return Flow::Return;
+                    }
+                }
+            }
+            else if constexpr (std::is_same_v<T, ast::ReturnStatement>) {
+                return_value_ = evaluate(stmt.expression, frame);
+                return Flow::Return;
+            }
+            else {
+                std::ignore = evaluate(stmt.expression, frame);
+            }
+
+            return Flow::Next;
+        }, statement.value);
+    }
+
+    [[nodiscard]] Flow execute(const std::span<const ast::Statement> statements, Value* const frame) {
+        for (const ast::Statement& statement : statements) {
+            if (execute(statement, frame) == Flow::Return) {
+                return Flow::Return;
+            }
+        }
+
+        return Flow::Next;
+    }
+
+    /// Runs the function whose arguments are the last values pushed on the stack.
+    [[nodiscard]] Value invoke(const ast::Function& function) {
+        const size_t base = top_ - function.arguments.size();
+        const size_t size = std::max<size_t>(function.slotCount, 1);
+        if (base + size > stack_.size() || depth_ == max_depth_) {
+            throw std::runtime_error {"Stack overflow"};
+        }
+
+        top_ = base + size;
+        ++depth_;
+        Value* const frame = stack_.data() + base;
+
+        Value result {};
+        if (execute(function.statements, frame) == Flow::Return) {
+            result = return_value_;
+        }
+        else if (function.lastExpression) {
+            result = evaluate(*function.lastExpression, frame);
+        }
+
+        top_ = base;
+        --depth_;
+        return result;
+    }
+
+    [[nodiscard]] Value call(const ast::FunctionCallExpression& expr, Value* const frame) {
+        if (expr.callee == ast::unresolved_index) {
+            if (expr.name == println_) {
+                println(expr.args, frame);
+                return 0;
+            }
+
+            throw std::runtime_error {std::format("Unknown function '{}'", unit_.symbols.name(expr.name))};
+        }
+
+        const ast::Function& function = unit_.functions[expr.callee];
+        if (expr.args.size() != function.arguments.size()) {
+            throw std::runtime_error {std::format("Function '{}' takes {} arguments",
+                unit_.symbols.name(function.name), function.arguments.size())};
+        }
+
+        for (const ast::Expression& arg : expr.args) {
+            const Value value = evaluate(arg, frame);
+            if (top_ == stack_.size()) {
+                throw std::runtime_error {"Stack overflow"};
+            }
+
+            stack_[top_++] = value; // the frame of the callee starts with its arguments
+        }
+
+        return invoke(function);
+    }
+
+    void println(const std::span<const ast::Expression> args, Value* const frame) {
+        if (args.empty() || !std::holds_alternative<ast::StringExpression>(args[0].value)) {
+            throw std::runtime_error {"println expects a format string"};
+        }
+
+        // every argument is evaluated left to right before formatting, like the bytecode and the compiled code
+        std::vector<Value> values;
+        values.reserve(args.size() - 1);
+        for (const ast::Expression& arg : args.subspan(1)) {
+            values.push_back(evaluate(arg, frame));
+        }
+
+        const std::string_view format = unit_.symbols.name(std::get<ast::StringExpression>(args[0].value).value);
+        std::string line;
+        size_t arg = 0;
+        for (size_t i = 0; i < format.size(); ++i) {
+            if (format.substr(i, 2) == "{}") {
+                if (arg == values.size()) {
+                    throw std::runtime_error {"println has not enough arguments"};
+                }
+
+                line += std::to_string(values[arg++]);
+                ++i;
+            }
+            else if (format.substr(i, 2) == "{{" || format.substr(i, 2) == "}}") {
+                line += format[i++];
+            }
+            else {
+                line += format[i];
+            }
+        }
+
+        out_ << line << '\n';
+    }
+
+public:
+    static constexpr size_t default_stack_size = 1024 * 1024;
+
+    /// Each call nests several native frames of the evaluator, deeper recursion than the limits allow raises
+    /// "Stack overflow" instead of exhausting the native stack.
+    explicit Interpreter(const ast::Unit& unit, std::ostream& out, const size_t stack_size = default_stack_size,
+        const CallLimits limits = {})
+        : unit_ {unit}
+        , out_ {out}
+        , stack_(stack_size)
+        , max_depth_ {limits.max_depth()}
+        , println_ {unit.symbols.find("println")} {
+    }
+
+    /// Calls a function of the unit by name.
+    Value call(const std::string_view name, const std::span<const Value> args = {}) {
+        const std::optional<ast::Symbol> symbol = unit_.symbols.find(name);
+        const auto function = std::ranges::find(unit_.functions, symbol, &ast::Function::name);
+        if (!symbol || function == unit_.functions.end()) {
+            throw std::runtime_error {std::format("Unknown function '{}'", name)};
+        }
+
+        if (args.size() != function->arguments.size() || top_ + args.size() > stack_.size()) {
+            throw std::runtime_error {std::format("Function '{}' takes {} arguments", name, function->arguments.size())};
+        }
+
+        const size_t top = top_;
+        const size_t depth = depth_;
+        std::ranges::copy(args, stack_.begin() + static_cast<ptrdiff_t>(top_));
+        top_ += args.size();
+        try {
+            return invoke(*function);
+        }
+        catch (...) {
+            top_ = top; // the frames of the failed call are dropped
+            depth_ = depth;
+            throw;
+        }
+    }
+
+    /// Runs the main function, the result is its value.
+    Value run() {
+        return call("main");
+    }
+};
+
+} // namespace skarn::interpreter
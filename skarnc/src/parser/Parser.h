@@ -6,7 +6,9 @@
 #include "details/ElemParser.h"
 #include "details/IntParser.h"
 #include "details/LiteralParser.h"
+#include "details/PrecedenceParser.h"
 #include "details/ReferenceParser.h"
+#include "details/RuleParser.h"
 #include "details/ConstantParser.h"
 #include "ParserInterface.h"
 
@@ -54,6 +56,10 @@ struct Parse final {
         return LiteralParser {str};
     }
 
+    static constexpr ParserInterface<KeywordParser> keyword(const std::string_view str) noexcept {
+        return KeywordParser {str};
+    }
+
     template <std::integral T = int>
     static constexpr ParserInterface<IntParser<T>> integer() noexcept {
         return {};
@@ -63,6 +69,29 @@ struct Parse final {
     static constexpr ParserInterface<ReferenceParser<Value>> ref() noexcept {
         return {};
     }
+
+    /// A recursive rule bound at compile time, see RuleParser.
+    template <class Rule, class Value>
+    static constexpr ParserInterface<RuleParser<Rule, Value>> rule() noexcept {
+        return {};
+    }
+
+    /// Binary operations over the atom, the levels are listed from the loosest binding, see PrecedenceParser.
+    template <details::Parser Atom, class Combine, details::Parser... Operators>
+    static constexpr ParserInterface<PrecedenceParser<Atom, Combine, Operators...>> precedence(
+        const ParserInterface<Atom>& atom, Combine combine, PrecedenceLevel<Operators>... levels) noexcept {
+        return PrecedenceParser<Atom, Combine, Operators...> {atom.parser(), std::move(combine), std::move(levels)...};
+    }
+
+    template <details::Parser Operators>
+    static constexpr PrecedenceLevel<Operators> left(const ParserInterface<Operators>& operators) noexcept {
+        return {operators.parser(), Associativity::Left};
+    }
+
+    template <details::Parser Operators>
+    static constexpr PrecedenceLevel<Operators> right(const ParserInterface<Operators>& operators) noexcept {
+        return {operators.parser(), Associativity::Right};
+    }
 };
 
 } // namespace skarn::parser
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <expected>
+#include "details/CaptureParser.h"
 #include "details/CharParser.h"
 #include "details/CombinedParser.h"
 #include "details/ExpectedParser.h"
@@ -8,6 +9,7 @@
 #include "details/LiteralParser.h"
 #include "details/OptionalParser.h"
 #include "details/ReferenceParser.h"
+#include "details/RuleParser.h"
 #include "details/SequenceParser.h"
 #include "details/TransformParser.h"
 #include "details/ValueParser.h"
@@ -50,6 +52,15 @@ public:
         return std::unexpected(std::move(context).messages());
     }
 
+    /// Parses using a context prepared by the caller, e.g. with the packrat mode enabled.
+    ParserResult<ValueType> parse(ParserContext<InputType>& context) const {
+        if (ValueType value {}; parser_.parse(context, value)) {
+            return {std::move(value)};
+        }
+
+        return std::unexpected(context.messages());
+    }
+
     template <details::Parser NextParser>
     constexpr auto operator >>(const ParserInterface<NextParser>& next) const noexcept {
         using ResultParser = decltype(makeCombinedParser(parser_, next.parser()));
@@ -72,6 +83,13 @@ public:
             TransformParser<Parser, Invocable> {parser_, std::move(invocable)}};
     }
 
+    template <details::ContextTransformInvocable<typename Parser::ValueType, InputType> Invocable>
+    requires (!details::TransformInvocable<Invocable, typename Parser::ValueType>)
+    constexpr auto operator >>(Invocable invocable) const noexcept {
+        return ParserInterface<TransformParser<Parser, Invocable>> {
+            TransformParser<Parser, Invocable> {parser_, std::move(invocable)}};
+    }
+
     template <details::Parser NextParser>
     constexpr auto operator ||(const ParserInterface<NextParser>& next) const noexcept {
         using ResultParser = decltype(makeVariantParser(parser_, next.parser()));
@@ -101,6 +119,13 @@ public:
         return ParserInterface<ResultParser> {makeOptionalParser(parser_)};
     }
 
+    /// Produces the matched source text as a view instead of building a value.
+    constexpr auto capture() const noexcept
+    requires (std::is_same_v<InputType, char>) {
+        using ResultParser = decltype(makeCaptureParser(parser_));
+        return ParserInterface<ResultParser> {makeCaptureParser(parser_)};
+    }
+
     template <details::Parser WrapParser>
     constexpr auto wrap(const ParserInterface<WrapParser>& wrapParser) const noexcept {
         return ~wrapParser >> *this >> ~wrapParser;
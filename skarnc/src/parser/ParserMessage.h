@@ -1,7 +1,14 @@
 #pragma once
 
+#include "TypeTraits.h"
+#include <array>
+#include <concepts>
 #include <cstdint>
+#include <format>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
 #include <vector>
 
 namespace skarn::parser {
@@ -32,4 +39,64 @@ struct ParserMessage {
 
 using ParseMessages = std::vector<ParserMessage>;
 
+enum class ParserErrorMode {
+    Collect,  // every reported message is kept
+    Farthest, // only expectations at the farthest failure offset are kept
+};
+
+/// Argument of a message stored inline, string arguments must outlive the parser context.
+using ParserMessageArg = std::variant<std::monostate, char, int64_t, uint64_t, std::string_view>;
+
+template <class T>
+constexpr ParserMessageArg make_message_arg(const T& value) noexcept {
+    if constexpr (std::is_same_v<T, char>) {
+        return value;
+    }
+    else if constexpr (std::signed_integral<T>) {
+        return static_cast<int64_t>(value);
+    }
+    else if constexpr (std::unsigned_integral<T>) {
+        return static_cast<uint64_t>(value);
+    }
+    else if constexpr (std::is_enum_v<T>) {
+        return make_message_arg(std::to_underlying(value));
+    }
+    else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        return std::string_view {value};
+    }
+    else {
+        static_assert(AlwaysFalse<T>, "Message arguments must be characters, integers or strings");
+    }
+}
+
+/// Compact message recorded while parsing, the text is formatted only when messages are read.
+struct ParserMessageRecord {
+    std::string_view format;
+    std::string_view what; // replaces the formatted text if not empty
+    std::array<ParserMessageArg, 2> args;
+    size_t offset;
+    ParserMsgLevel level;
+    ParserMsgCode code;
+
+    bool operator ==(const ParserMessageRecord&) const = default;
+
+    [[nodiscard]] std::string text() const {
+        if (!what.empty()) {
+            return std::string {what};
+        }
+
+        return std::visit([this]<class Arg0, class Arg1>(const Arg0& arg0, const Arg1& arg1) {
+            if constexpr (std::is_same_v<Arg0, std::monostate>) {
+                return std::vformat(format, std::make_format_args());
+            }
+            else if constexpr (std::is_same_v<Arg1, std::monostate>) {
+                return std::vformat(format, std::make_format_args(arg0));
+            }
+            else {
+                return std::vformat(format, std::make_format_args(arg0, arg1));
+            }
+        }, args[0], args[1]);
+    }
+};
+
 } // namespace skarn::parser
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "ParserContext.h"
+#include <string_view>
+
+namespace skarn::parser {
+
+/// Parser that produces the matched input range instead of the value of the wrapped parser.
+/// The view refers to the parsed source, which must outlive it; with chunked input it is valid until the input is read again.
+template <details::Parser Parser>
+requires (std::is_same_v<typename Parser::InputType, char>)
+class CaptureParser final {
+    Parser parser_;
+
+public:
+    using ParserType = CaptureParser;
+    using InputType = char;
+    using ValueType = std::string_view;
+
+    explicit constexpr CaptureParser(Parser parser) noexcept
+        : parser_ {std::move(parser)} {
+    }
+
+    [[nodiscard]] constexpr const Parser& parser() const noexcept {
+        return parser_;
+    }
+
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        return details::first_set_of(parser_);
+    }
+
+    bool parse(ParserContext<InputType>& ctx, ValueType& value) const {
+        const ParserCheckpoint checkpoint {ctx};
+        if (!parser_.parse(ctx)) {
+            return false;
+        }
+
+        const std::span<const char> captured = ctx.input_from(checkpoint.position());
+        value = std::string_view {captured.data(), captured.size()};
+        return true;
+    }
+
+    bool parse(ParserContext<InputType>& ctx) const {
+        return parser_.parse(ctx);
+    }
+};
+
+template <details::Parser Parser>
+constexpr auto makeCaptureParser(Parser parser) noexcept {
+    if constexpr (SpecializationOf<Parser, CaptureParser>) {
+        return parser;
+    }
+    else {
+        return CaptureParser<Parser> {std::move(parser)};
+    }
+}
+
+} // namespace skarn::parser
@@ -16,6 +16,10 @@ public:
         : char_ {character} {
     }
 
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        return FirstSet {CharSet::of(char_), false};
+    }
+
     bool parse(ParserContext<char>& ctx, char& value) const {
         const std::span<const char> input = ctx.input();
         if (input.empty()) {
@@ -1,14 +1,32 @@
 #pragma once
 
+#include "CharScanner.h"
 #include "ParserContext.h"
 #include <concepts>
 
 namespace skarn::parser {
 
+namespace details {
+struct NoCharScanner final {
+};
+} // namespace details
+
 template <std::predicate<char> Predicate>
 class CharPredicateParser final {
+    using Scanner = std::conditional_t<details::ConstexprCharPredicate<Predicate>, CharScanner, details::NoCharScanner>;
+
     Predicate predicate_;
     std::string_view what_;
+    [[no_unique_address]] Scanner scanner_;
+
+    static constexpr Scanner makeScanner(const Predicate& predicate) noexcept {
+        if constexpr (details::ConstexprCharPredicate<Predicate>) {
+            return CharScanner {CharSet::of(predicate)};
+        }
+        else {
+            return {};
+        }
+    }
 
 public:
     using ParserType = CharPredicateParser;
@@ -17,7 +35,32 @@ public:
 
     explicit constexpr CharPredicateParser(Predicate predicate, const std::string_view what) noexcept
         : predicate_ {std::move(predicate)}
-        , what_ {what} {
+        , what_ {what}
+        , scanner_ {makeScanner(predicate_)} {
+    }
+
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        if constexpr (details::ConstexprCharPredicate<Predicate>) {
+            return FirstSet {scanner_.chars(), false};
+        }
+        else {
+            return FirstSet::any();
+        }
+    }
+
+    /// Returns the length of the longest prefix of the input matching the predicate.
+    [[nodiscard]] size_t scan(const std::span<const char> input) const {
+        if constexpr (details::ConstexprCharPredicate<Predicate>) {
+            return scanner_.scan(input);
+        }
+        else {
+            size_t length = 0;
+            while (length < input.size() && predicate_(input[length])) {
+                ++length;
+            }
+
+            return length;
+        }
     }
 
     bool parse(ParserContext<char>& ctx, char& value) const {
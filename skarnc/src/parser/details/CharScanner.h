@@ -0,0 +1,144 @@
+#pragma once
+
+#include "CharSet.h"
+#include "Simd.h"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+
+namespace skarn::parser {
+
+/// Finds the longest prefix of the input consisting of characters from a set.
+/// Sets made of a few ranges are checked 16 or 32 characters at a time.
+class CharScanner final {
+public:
+    static constexpr size_t max_ranges = 4;
+
+private:
+    struct Range {
+        uint8_t first;
+        uint8_t width; // last - first
+    };
+
+    CharSet chars_;
+    std::array<Range, max_ranges> ranges_ {};
+    size_t range_count_ {}; // 0 if the set is empty or needs more ranges
+
+#ifdef SKARN_PARSER_SSE2
+    // advances the position over whole chunks, returns true if a character out of the set was found
+    bool scanSse2(const char* const data, const size_t size, size_t& position) const noexcept {
+        __m128i firsts[max_ranges];
+        __m128i widths[max_ranges];
+        for (size_t r = 0; r < range_count_; ++r) {
+            firsts[r] = _mm_set1_epi8(static_cast<char>(ranges_[r].first));
+            widths[r] = _mm_set1_epi8(static_cast<char>(ranges_[r].width));
+        }
+
+        for (; position + 16 <= size; position += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+            __m128i matches = _mm_setzero_si128();
+            for (size_t r = 0; r < range_count_; ++r) {
+                // chr - first <= width as unsigned bytes
+                const __m128i shifted = _mm_sub_epi8(chunk, firsts[r]);
+                matches = _mm_or_si128(matches, _mm_cmpeq_epi8(_mm_min_epu8(shifted, widths[r]), shifted));
+            }
+
+            if (const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(matches)); mask != 0xFFFF) {
+                position += static_cast<size_t>(std::countr_one(mask));
+                return true;
+            }
+        }
+
+        return false;
+    }
+#endif
+
+#ifdef SKARN_PARSER_AVX2
+    bool scanAvx2(const char* const data, const size_t size, size_t& position) const noexcept {
+        __m256i firsts[max_ranges];
+        __m256i widths[max_ranges];
+        for (size_t r = 0; r < range_count_; ++r) {
+            firsts[r] = _mm256_set1_epi8(static_cast<char>(ranges_[r].first));
+            widths[r] = _mm256_set1_epi8(static_cast<char>(ranges_[r].width));
+        }
+
+        for (; position + 32 <= size; position += 32) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position));
+            __m256i matches = _mm256_setzero_si256();
+            for (size_t r = 0; r < range_count_; ++r) {
+                const __m256i shifted = _mm256_sub_epi8(chunk, firsts[r]);
+                matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, widths[r]), shifted));
+            }
+
+            if (const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(matches)); mask != ~uint32_t {}) {
+                position += static_cast<size_t>(std::countr_one(mask));
+                return true;
+            }
+        }
+
+        return false;
+    }
+#endif
+
+public:
+    explicit constexpr CharScanner(const CharSet& chars) noexcept
+        : chars_ {chars} {
+        size_t count = 0;
+        for (unsigned chr = 0; chr < 256; ++chr) {
+            if (!chars.contains(static_cast<char>(chr))) {
+                continue;
+            }
+
+            unsigned last = chr;
+            while (last < 255 && chars.contains(static_cast<char>(last + 1))) {
+                ++last;
+            }
+
+            if (count == max_ranges) {
+                count = 0;
+                break;
+            }
+
+            ranges_[count++] = Range {static_cast<uint8_t>(chr), static_cast<uint8_t>(last - chr)};
+            chr = last;
+        }
+
+        range_count_ = count;
+    }
+
+    [[nodiscard]] constexpr const CharSet& chars() const noexcept {
+        return chars_;
+    }
+
+    [[nodiscard]] constexpr size_t range_count() const noexcept {
+        return range_count_;
+    }
+
+    [[nodiscard]] size_t scan(const std::span<const char> input) const noexcept {
+        const char* const data = input.data();
+        const size_t size = input.size();
+        size_t i = 0;
+
+        if (range_count_ != 0) {
+#ifdef SKARN_PARSER_AVX2
+            if (scanAvx2(data, size, i)) {
+                return i;
+            }
+#endif
+#ifdef SKARN_PARSER_SSE2
+            if (scanSse2(data, size, i)) {
+                return i;
+            }
+#endif
+        }
+
+        while (i < size && chars_.contains(data[i])) {
+            ++i;
+        }
+
+        return i;
+    }
+};
+
+} // namespace skarn::parser
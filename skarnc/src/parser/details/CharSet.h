@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+namespace skarn::parser {
+
+/// Set of byte values.
+class CharSet final {
+    std::array<uint64_t, 4> bits_ {};
+
+public:
+    constexpr CharSet() noexcept = default;
+
+    static constexpr CharSet all() noexcept {
+        CharSet result;
+        result.bits_.fill(~uint64_t {});
+        return result;
+    }
+
+    static constexpr CharSet of(const char chr) noexcept {
+        CharSet result;
+        result.insert(chr);
+        return result;
+    }
+
+    static constexpr CharSet range(const char first, const char last) noexcept {
+        CharSet result;
+        for (unsigned chr = static_cast<unsigned char>(first); chr <= static_cast<unsigned char>(last); ++chr) {
+            result.insert(static_cast<char>(chr));
+        }
+
+        return result;
+    }
+
+    template <std::predicate<char> Predicate>
+    static constexpr CharSet of(const Predicate& predicate) {
+        CharSet result;
+        for (unsigned chr = 0; chr != 256; ++chr) {
+            if (predicate(static_cast<char>(chr))) {
+                result.insert(static_cast<char>(chr));
+            }
+        }
+
+        return result;
+    }
+
+    constexpr void insert(const char chr) noexcept {
+        const auto index = static_cast<unsigned char>(chr);
+        bits_[index / 64] |= uint64_t {1} << (index % 64);
+    }
+
+    [[nodiscard]] constexpr bool contains(const char chr) const noexcept {
+        const auto index = static_cast<unsigned char>(chr);
+        return (bits_[index / 64] >> (index % 64) & 1) != 0;
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept {
+        return (bits_[0] | bits_[1] | bits_[2] | bits_[3]) == 0;
+    }
+
+    constexpr CharSet& operator |=(const CharSet& other) noexcept {
+        for (size_t i = 0; i < bits_.size(); ++i) {
+            bits_[i] |= other.bits_[i];
+        }
+
+        return *this;
+    }
+
+    [[nodiscard]] friend constexpr CharSet operator |(CharSet lhs, const CharSet& rhs) noexcept {
+        return lhs |= rhs;
+    }
+
+    constexpr bool operator ==(const CharSet&) const noexcept = default;
+};
+
+/// Characters a parser can start with, and whether it can succeed without consuming input.
+struct FirstSet {
+    CharSet chars;
+    bool nullable;
+
+    /// Unknown FIRST set, the parser must always be tried.
+    static constexpr FirstSet any() noexcept {
+        return FirstSet {CharSet::all(), true};
+    }
+
+    static constexpr FirstSet empty() noexcept {
+        return FirstSet {CharSet {}, true};
+    }
+
+    constexpr bool operator ==(const FirstSet&) const noexcept = default;
+};
+
+namespace details {
+/// Predicate that can be evaluated at compile time, so its character set can be computed.
+template <class Predicate>
+concept ConstexprCharPredicate = std::default_initializable<Predicate> &&
+    requires { typename std::bool_constant<(Predicate {}('a'), true)>; };
+
+template <class Parser>
+constexpr FirstSet first_set_of(const Parser& parser) noexcept {
+    if constexpr (requires { { parser.first_set() } -> std::same_as<FirstSet>; }) {
+        return parser.first_set();
+    }
+    else {
+        return FirstSet::any();
+    }
+}
+} // namespace details
+
+} // namespace skarn::parser
@@ -77,6 +77,22 @@ public:
         return parsers_;
     }
 
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        FirstSet result = FirstSet::empty();
+        std::apply([&result](const Parsers&...parsers) constexpr noexcept {
+            const auto add = [&result](const FirstSet& first) constexpr noexcept {
+                result.chars |= first.chars;
+                result.nullable = first.nullable;
+                return first.nullable;
+            };
+
+            // a parser contributes only while all the parsers before it can succeed without consuming input
+            std::ignore = (add(details::first_set_of(parsers)) && ...);
+        }, parsers_);
+
+        return result;
+    }
+
     // for tuple
     bool parse(ParserContext<InputType>& ctx, ValueType& value) const
     requires (ValueTypePack::size > 1) {
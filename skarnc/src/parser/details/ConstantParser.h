@@ -17,6 +17,10 @@ public:
         : value_ {std::move(value)} {
     }
 
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        return FirstSet::empty();
+    }
+
     template <class Elem>
     bool parse([[maybe_unused]] ParserContext<Elem>& ctx, Value& value) const
     requires (!std::is_same_v<Value, NoValueType>) {
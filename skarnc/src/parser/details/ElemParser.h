@@ -17,6 +17,15 @@ public:
         : elem_ {std::move(elem)} {
     }
 
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        if constexpr (std::is_same_v<Elem, char>) {
+            return FirstSet {CharSet::of(elem_), false};
+        }
+        else {
+            return FirstSet::any();
+        }
+    }
+
     bool parse(ParserContext<Elem>& ctx, Elem& value) const {
         const std::span<const Elem> input = ctx.input();
         if (input.empty()) {
@@ -28,13 +28,15 @@ public:
         return what_;
     }
 
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        return details::first_set_of(parser_);
+    }
+
     bool parse(ParserContext<InputType>& ctx, ValueType& value) const
     requires (!std::is_same_v<ValueType, NoValueType>) {
-        if (!parser_.parse(ctx, value)) {
-            if (ctx.report_messages()) {
-                ctx.messages().back().expected = what_;
-            }
-
+        if (const ParserMessageMark mark = ctx.message_mark();
+            !parser_.parse(ctx, value)) {
+            ctx.set_expected(mark, what_);
             return false;
         }
 
@@ -42,11 +44,9 @@ public:
     }
 
     bool parse(ParserContext<InputType>& ctx) const {
-        if (!parser_.parse(ctx)) {
-            if (ctx.report_messages()) {
-                ctx.messages().back().expected = what_;
-            }
-
+        if (const ParserMessageMark mark = ctx.message_mark();
+            !parser_.parse(ctx)) {
+            ctx.set_expected(mark, what_);
             return false;
         }
 
@@ -18,6 +18,19 @@ public:
         : parser_ {std::move(parser)} {
     }
 
+    [[nodiscard]] constexpr const Parser& parser() const noexcept {
+        return parser_;
+    }
+
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        return details::first_set_of(parser_);
+    }
+
+    [[nodiscard]] size_t scan(const std::span<const char> input) const
+    requires (details::ScanParser<Parser>) {
+        return parser_.scan(input);
+    }
+
     bool parse(ParserContext<InputType>& ctx, [[maybe_unused]] ValueType& value) const
     requires (!std::is_same_v<ValueType, NoValueType>) {
         return parser_.parse(ctx);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ParserContext.h"
+#include <algorithm>
 #include <charconv>
 
 namespace skarn::parser {
@@ -12,6 +13,20 @@ public:
     using InputType = char;
     using ValueType = T;
 
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        CharSet chars = CharSet::range('0', static_cast<char>('0' + std::min(Base, 10) - 1));
+        if constexpr (Base > 10) {
+            chars |= CharSet::range('a', static_cast<char>('a' + Base - 11));
+            chars |= CharSet::range('A', static_cast<char>('A' + Base - 11));
+        }
+
+        if constexpr (std::is_signed_v<T>) {
+            chars.insert('-');
+        }
+
+        return FirstSet {chars, false};
+    }
+
     bool parse(ParserContext<char>& ctx, T& value) const {
         const std::span<const char> input = ctx.input();
         if (input.empty()) {
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Simd.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace skarn::parser {
+
+struct SourceLocation {
+    uint32_t line;
+    uint32_t column;
+};
+
+/// Table of line start offsets of a source, used to map offsets to 1-based lines and columns on demand.
+class LineIndex final {
+    std::vector<size_t> line_starts_;
+
+public:
+    explicit LineIndex(const std::span<const char> source) {
+        line_starts_.push_back(0);
+
+        const char* const data = source.data();
+        const size_t size = source.size();
+        size_t i = 0;
+
+#ifdef SKARN_PARSER_SSE2
+        const __m128i newline = _mm_set1_epi8('\n');
+        for (; i + 16 <= size; i += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+            while (mask != 0) {
+                line_starts_.push_back(i + static_cast<size_t>(std::countr_zero(mask)) + 1);
+                mask &= mask - 1;
+            }
+        }
+#endif
+
+        for (; i < size; ++i) {
+            if (data[i] == '\n') {
+                line_starts_.push_back(i + 1);
+            }
+        }
+    }
+
+    [[nodiscard]] size_t line_count() const noexcept {
+        return line_starts_.size();
+    }
+
+    [[nodiscard]] SourceLocation location(const size_t offset) const noexcept {
+        const auto it = std::ranges::upper_bound(line_starts_, offset);
+        const auto line = static_cast<size_t>(it - line_starts_.begin());
+        return SourceLocation {
+            .line = static_cast<uint32_t>(line),
+            .column = static_cast<uint32_t>(offset - line_starts_[line - 1] + 1),
+        };
+    }
+};
+
+} // namespace skarn::parser
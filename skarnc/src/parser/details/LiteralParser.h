@@ -17,6 +17,10 @@ public:
     {
     }
 
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        return literal_.empty() ? FirstSet::empty() : FirstSet {CharSet::of(literal_[0]), false};
+    }
+
     bool parse(ParserContext<char>& ctx, std::string_view& value) const {
         const std::span<const char> input = ctx.input();
         if (input.empty()) {
@@ -41,4 +45,45 @@ public:
     }
 };
 
+/// Literal that is not followed by an identifier character, e.g. the keyword of "return x" but not of "returnCode".
+class KeywordParser final {
+    LiteralParser literal_;
+    std::string_view keyword_;
+
+    static constexpr bool isIdentifierChar(const char c) noexcept {
+        return c >= 'a' && c <= 'z' || c >= 'A' && c <= 'Z' || c >= '0' && c <= '9' || c == '_';
+    }
+
+public:
+    using ParserType = KeywordParser;
+    using InputType = char;
+    using ValueType = std::string_view;
+
+    explicit constexpr KeywordParser(const std::string_view keyword) noexcept
+        : literal_ {keyword}
+        , keyword_ {keyword}
+    {
+    }
+
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        return literal_.first_set();
+    }
+
+    bool parse(ParserContext<char>& ctx, std::string_view& value) const {
+        const std::span<const char> input = ctx.input();
+        if (input.size() > keyword_.size() && isIdentifierChar(input[keyword_.size()]) &&
+            std::string_view {input.data(), input.size()}.starts_with(keyword_)) {
+            ctx.add_message(ParserMsgLevel::Error, ParserMsgCode::C0002, "'{}'", keyword_);
+            return false;
+        }
+
+        return literal_.parse(ctx, value);
+    }
+
+    bool parse(ParserContext<char>& ctx) const {
+        std::string_view value;
+        return parse(ctx, value);
+    }
+};
+
 } // namespace skarn::parser
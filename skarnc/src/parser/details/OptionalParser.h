@@ -25,15 +25,19 @@ public:
         return parser_;
     }
 
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        return FirstSet {details::first_set_of(parser_).chars, true};
+    }
+
     bool parse(ParserContext<InputType>& ctx, ValueType& value) const
     requires (!std::is_same_v<ValueType, NoValueType>) {
         value.emplace();
         const bool report_flag = ctx.report_messages();
         ctx.report_messages(false);
-        const ParserPosition position = ctx.position();
+        const ParserCheckpoint checkpoint {ctx};
         if (!parser_.parse(ctx, *value)) {
             value.reset();
-            ctx.position(position); // restore position
+            checkpoint.restore(); // restore position
         }
 
         ctx.report_messages(report_flag); // restore report flag
@@ -43,9 +47,9 @@ public:
     bool parse(ParserContext<InputType>& ctx) const {
         const bool report_flag = ctx.report_messages();
         ctx.report_messages(false);
-        const ParserPosition position = ctx.position();
+        const ParserCheckpoint checkpoint {ctx};
         if (!parser_.parse(ctx)) {
-            ctx.position(position); // restore position
+            checkpoint.restore(); // restore position
         }
 
         ctx.report_messages(report_flag); // restore report flag
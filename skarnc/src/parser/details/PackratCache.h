@@ -0,0 +1,67 @@
+#pragma once
+
+#include "ParserPosition.h"
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace skarn::parser {
+
+struct PackratStats {
+    size_t hits;
+    size_t misses;
+};
+
+namespace details {
+/// Memoization table of the packrat mode, keyed on (rule, offset).
+class PackratCache final {
+public:
+    struct Entry {
+        std::shared_ptr<const void> value; // empty if the rule failed or the value was not requested
+        ParserPosition end;
+        bool success;
+    };
+
+private:
+    struct Key {
+        const void* rule;
+        size_t offset;
+
+        bool operator ==(const Key&) const noexcept = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const noexcept {
+            const size_t hash = std::hash<const void*> {}(key.rule);
+            return hash ^ (key.offset + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2));
+        }
+    };
+
+    std::unordered_map<Key, Entry, KeyHash> entries_;
+    PackratStats stats_ {};
+
+public:
+    [[nodiscard]] const Entry* find(const void* const rule, const size_t offset) const {
+        const auto it = entries_.find(Key {rule, offset});
+        return it != entries_.end() ? &it->second : nullptr;
+    }
+
+    void store(const void* const rule, const size_t offset, Entry entry) {
+        entries_.insert_or_assign(Key {rule, offset}, std::move(entry));
+    }
+
+    void hit() noexcept {
+        ++stats_.hits;
+    }
+
+    void miss() noexcept {
+        ++stats_.misses;
+    }
+
+    [[nodiscard]] PackratStats stats() const noexcept {
+        return stats_;
+    }
+};
+} // namespace details
+
+} // namespace skarn::parser
@@ -1,33 +1,192 @@
 #pragma once
 
 #include "../ParserMessage.h"
+#include "CharSet.h"
+#include "LineIndex.h"
+#include "PackratCache.h"
+#include "ParserPosition.h"
 #include "TypePack.h"
+#include <algorithm>
 #include <cstdint>
 #include <format>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace skarn::parser {
 
-struct ParserPosition {
+/// State of the messages when a parser starts, see ParserContext::set_expected.
+struct ParserMessageMark {
     size_t offset;
-    uint32_t line;
-    uint32_t column;
+    size_t count;
+    size_t farthest_offset;
 };
 
+namespace details {
+template <class T>
+inline constexpr char user_data_key {};
+} // namespace details
+
+/// Fills the buffer with the next part of the input and returns the number of elements read, 0 at the end.
+template <class Input>
+using InputReader = std::function<size_t(std::span<Input> buffer)>;
+
 template <class Input>
 class ParserContext final {
-    ParseMessages messages_;
+    std::vector<ParserMessageRecord> messages_;
     std::span<const Input> input_;
-    ParserPosition position_ {0, 1, 1};
+    ParserPosition position_ {0};
+    mutable std::optional<LineIndex> lines_; // built when messages are read
+    std::unique_ptr<details::PackratCache> packrat_;
+    std::vector<std::pair<const void*, void*>> user_data_; // (type key, object)
+    size_t farthest_offset_ {0};
+    ParserErrorMode error_mode_ {ParserErrorMode::Collect};
     bool report_messages_ {true};
 
+    // chunked input: input_ is a window of buffer_ starting at window_offset_, see the reader constructor
+    InputReader<Input> reader_;
+    std::vector<Input> buffer_;
+    size_t window_offset_ {0};
+    size_t chunk_size_ {0};
+    size_t checkpoints_ {0};
+    size_t checkpoint_offset_ {0}; // offset of the oldest live checkpoint
+    SourceLocation window_location_ {1, 1};
+    std::vector<std::pair<size_t, SourceLocation>> released_locations_; // of the messages before the window
+
+    [[nodiscard]] size_t available() const noexcept {
+        return input_.size() - (position_.offset - window_offset_);
+    }
+
+    // drops the input no parser can return to and reads chunks until the lookahead is available
+    void pull() {
+        const size_t keep = checkpoints_ != 0 ? std::min(checkpoint_offset_, position_.offset) : position_.offset;
+        if (keep - window_offset_ >= buffer_.size() / 2) {
+            release(keep);
+        }
+
+        while (reader_ && available() < chunk_size_) {
+            const size_t size = buffer_.size();
+            buffer_.resize(size + chunk_size_);
+            const size_t count = reader_(std::span<Input> {buffer_}.subspan(size));
+            buffer_.resize(size + count);
+            input_ = buffer_;
+            if (count == 0) {
+                reader_ = nullptr;
+            }
+        }
+    }
+
+    void release(const size_t offset) {
+        for (const ParserMessageRecord& record : messages_) {
+            if (record.offset >= window_offset_ && record.offset < offset) {
+                released_locations_.emplace_back(record.offset, windowLocation(record.offset));
+            }
+        }
+
+        window_location_ = windowLocation(offset);
+        buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(offset - window_offset_));
+        input_ = buffer_;
+        window_offset_ = offset;
+    }
+
+    // counts the lines from the start of the window, used in the chunked mode only
+    [[nodiscard]] SourceLocation windowLocation(const size_t offset) const {
+        SourceLocation location = window_location_;
+        if constexpr (std::is_same_v<Input, char>) {
+            for (const char chr : input_.first(std::min(offset - window_offset_, input_.size()))) {
+                if (chr == '\n') {
+                    ++location.line;
+                    location.column = 1;
+                }
+                else {
+                    ++location.column;
+                }
+            }
+        }
+        else {
+            location.column = static_cast<uint32_t>(offset + 1);
+        }
+
+        return location;
+    }
+
+    void addFarthest(const ParserMessageRecord& record) {
+        if (!messages_.empty()) {
+            if (record.offset < farthest_offset_) {
+                return;
+            }
+
+            if (record.offset > farthest_offset_) {
+                messages_.clear();
+            }
+            else if (std::ranges::find(messages_, record) != messages_.end()) {
+                return;
+            }
+        }
+
+        farthest_offset_ = record.offset;
+        messages_.push_back(record);
+    }
+
+    [[nodiscard]] ParseMessages farthestMessages() const {
+        if (messages_.empty()) {
+            return {};
+        }
+
+        std::string expected = messages_[0].text();
+        for (size_t i = 1; i < messages_.size(); ++i) {
+            expected += i + 1 == messages_.size() ? " or " : ", ";
+            expected += messages_[i].text();
+        }
+
+        const ParserMessageRecord& first = messages_[0];
+        const SourceLocation location = this->location(first.offset);
+        return {ParserMessage {
+            .level = first.level,
+            .code = first.code,
+            .expected = std::move(expected),
+            .offset = first.offset,
+            .line = location.line,
+            .column = location.column,
+        }};
+    }
+
 public:
     explicit ParserContext(const std::span<const Input> input) noexcept
         : input_ {input} {
     }
 
-    [[nodiscard]] std::span<const Input> input() const {
-        return input_.subspan(position_.offset);
+    /// Chunked input: chunks are pulled from the reader while less than a chunk is available, the input before
+    /// the oldest live ParserCheckpoint is released, so the memory is bounded by the backtrack distance instead of
+    /// the input size. Parsers other than runs of SequenceParser look ahead at most a chunk, so a chunk must be
+    /// longer than literals and numbers. Spans and views of the input, e.g. captures, are only valid until
+    /// the input is read again.
+    explicit ParserContext(InputReader<Input> reader, const size_t chunk_size = 64 << 10)
+        : reader_ {std::move(reader)}
+        , chunk_size_ {std::max<size_t>(chunk_size, 1)} {
+    }
+
+    /// The rest of the input, in the chunked mode at least a chunk is available unless the input ends.
+    [[nodiscard]] std::span<const Input> input() {
+        if (reader_ && available() < chunk_size_) {
+            pull();
+        }
+
+        return input_.subspan(position_.offset - window_offset_);
+    }
+
+    /// Number of the input elements held by the context, the whole input unless it is chunked.
+    [[nodiscard]] size_t buffered_size() const noexcept {
+        return input_.size();
+    }
+
+    /// The input from the position to the current position, the position must be kept by a checkpoint.
+    [[nodiscard]] std::span<const Input> input_from(const ParserPosition position) const noexcept {
+        return input_.subspan(position.offset - window_offset_, position_.offset - position.offset);
     }
 
     [[nodiscard]] ParserPosition position() const noexcept {
@@ -39,21 +198,67 @@ public:
     }
 
     void consume(const size_t length) noexcept {
-        // TODO: calculate line and column
         position_.offset += length;
-        position_.column += static_cast<uint32_t>(length);
     }
 
-    [[nodiscard]] ParseMessages& messages() & noexcept {
-        return messages_;
+    void add_checkpoint(const ParserPosition position) noexcept {
+        if (checkpoints_++ == 0) {
+            checkpoint_offset_ = position.offset;
+        }
     }
 
-    [[nodiscard]] const ParseMessages& messages() const & noexcept {
-        return messages_;
+    void remove_checkpoint() noexcept {
+        --checkpoints_;
+    }
+
+    /// Maps an offset to a line and a column, lines are only counted when a location is requested.
+    [[nodiscard]] SourceLocation location(const size_t offset) const {
+        if (chunk_size_ != 0) {
+            if (offset >= window_offset_) {
+                return windowLocation(offset);
+            }
+
+            const auto it = std::ranges::find(released_locations_, offset, &std::pair<size_t, SourceLocation>::first);
+            return it != released_locations_.end() ? it->second : SourceLocation {1, 1};
+        }
+
+        if constexpr (std::is_same_v<Input, char>) {
+            if (!lines_) {
+                lines_.emplace(input_);
+            }
+
+            return lines_->location(offset);
+        }
+        else {
+            return SourceLocation {1, static_cast<uint32_t>(offset + 1)};
+        }
+    }
+
+    /// Formats the recorded messages, in the farthest mode a single message lists all expectations.
+    [[nodiscard]] ParseMessages messages() const {
+        if (error_mode_ == ParserErrorMode::Farthest) {
+            return farthestMessages();
+        }
+
+        ParseMessages messages;
+        messages.reserve(messages_.size());
+        for (const ParserMessageRecord& record : messages_) {
+            const SourceLocation location = this->location(record.offset);
+            messages.push_back(ParserMessage {
+                .level = record.level,
+                .code = record.code,
+                .expected = record.text(),
+                .offset = record.offset,
+                .line = location.line,
+                .column = location.column,
+            });
+        }
+
+        return messages;
     }
 
-    [[nodiscard]] ParseMessages messages() && noexcept {
-        return std::move(messages_);
+    [[nodiscard]] const std::vector<ParserMessageRecord>& message_records() const noexcept {
+        return messages_;
     }
 
     [[nodiscard]] bool report_messages() const noexcept {
@@ -64,18 +269,151 @@ public:
         report_messages_ = value;
     }
 
+    [[nodiscard]] ParserErrorMode error_mode() const noexcept {
+        return error_mode_;
+    }
+
+    void error_mode(const ParserErrorMode mode) noexcept {
+        error_mode_ = mode;
+        messages_.clear();
+        farthest_offset_ = 0;
+    }
+
+    /// Whether failures are observable, i.e. a failed parser cannot be skipped without changing messages.
+    [[nodiscard]] bool track_failures() const noexcept {
+        return report_messages_ || error_mode_ == ParserErrorMode::Farthest;
+    }
+
+    [[nodiscard]] bool packrat() const noexcept {
+        return packrat_ != nullptr;
+    }
+
+    /// Enables memoization of rule results (packrat parsing), see ReferenceParser.
+    void packrat(const bool value) {
+        if (!value) {
+            packrat_.reset();
+        }
+        else if (!packrat_) {
+            packrat_ = std::make_unique<details::PackratCache>();
+        }
+    }
+
+    [[nodiscard]] details::PackratCache* packrat_cache() const noexcept {
+        return packrat_.get();
+    }
+
+    [[nodiscard]] PackratStats packrat_stats() const noexcept {
+        return packrat_ ? packrat_->stats() : PackratStats {};
+    }
+
+    /// Attaches an object owned by the caller, transforms can reach it with user_data<T>().
+    template <class T>
+    void user_data(T& data) {
+        const void* const key = &details::user_data_key<T>;
+        if (const auto it = std::ranges::find(user_data_, key, &std::pair<const void*, void*>::first);
+            it != user_data_.end()) {
+            it->second = &data;
+        }
+        else {
+            user_data_.emplace_back(key, &data);
+        }
+    }
+
+    template <class T>
+    [[nodiscard]] T& user_data() const {
+        const void* const key = &details::user_data_key<T>;
+        const auto it = std::ranges::find(user_data_, key, &std::pair<const void*, void*>::first);
+        if (it == user_data_.end()) {
+            throw std::logic_error {"User data is not attached to the parser context"};
+        }
+
+        return *static_cast<T*>(it->second);
+    }
+
     template <class...Args>
+    requires (sizeof...(Args) <= 2)
     void add_message(const ParserMsgLevel level, const ParserMsgCode code, std::format_string<Args...> fmt, Args&&...args) {
-        if (report_messages_) {
-            messages_.push_back(ParserMessage {
-                .level = level,
+        if (!track_failures()) {
+            return;
+        }
+
+        const ParserMessageRecord record {
+            .format = fmt.get(),
+            .what = {},
+            .args = {make_message_arg(std::as_const(args))...},
+            .offset = position_.offset,
+            .level = level,
+            .code = code,
+        };
+
+        if (error_mode_ == ParserErrorMode::Farthest) {
+            addFarthest(record);
+        }
+        else {
+            messages_.push_back(record);
+        }
+    }
+
+    [[nodiscard]] ParserMessageMark message_mark() const noexcept {
+        return ParserMessageMark {position_.offset, messages_.size(), farthest_offset_};
+    }
+
+    /// Replaces the expectation of a failed parser started at the mark.
+    /// In the collect mode the last reported message is updated, in the farthest mode the expectations
+    /// at the start offset are replaced unless the parser failed further.
+    void set_expected(const ParserMessageMark& mark, const std::string_view what) {
+        if (error_mode_ == ParserErrorMode::Farthest) {
+            ParserMsgCode code = ParserMsgCode::C0002;
+            if (!messages_.empty() && farthest_offset_ == mark.offset) {
+                const size_t count = mark.farthest_offset == mark.offset ? mark.count : 0;
+                if (count < messages_.size()) {
+                    code = messages_[count].code;
+                }
+
+                messages_.resize(count);
+            }
+
+            addFarthest(ParserMessageRecord {
+                .format = {},
+                .what = what,
+                .args = {},
+                .offset = mark.offset,
+                .level = ParserMsgLevel::Error,
                 .code = code,
-                .expected = std::format(fmt, std::forward<Args>(args)...),
-                .offset = position_.offset,
-                .line = position_.line,
-                .column = position_.column,
             });
         }
+        else if (report_messages_ && !messages_.empty()) {
+            messages_.back().what = what;
+        }
+    }
+};
+
+/// Position a parser may return to, keeps the input from it while it is alive in the chunked mode.
+template <class Input>
+class ParserCheckpoint final {
+    ParserContext<Input>& ctx_;
+    ParserPosition position_;
+
+public:
+    explicit ParserCheckpoint(ParserContext<Input>& ctx) noexcept
+        : ctx_ {ctx}
+        , position_ {ctx.position()} {
+        ctx_.add_checkpoint(position_);
+    }
+
+    ParserCheckpoint(const ParserCheckpoint&) = delete;
+    ParserCheckpoint& operator=(const ParserCheckpoint&) = delete;
+
+    ~ParserCheckpoint() {
+        ctx_.remove_checkpoint();
+    }
+
+    [[nodiscard]] ParserPosition position() const noexcept {
+        return position_;
+    }
+
+    void restore() const noexcept {
+        ctx_.position(position_);
     }
 };
 
@@ -98,6 +436,13 @@ concept Parser = std::is_same_v<typename T::InputType, AnyInputType> ||
         { p.parse(c, v) } -> std::same_as<bool>;
     });
 
+/// Single character parser that can match a run of characters in one pass, see SequenceParser.
+template <class T>
+concept ScanParser = Parser<T> && std::is_same_v<typename T::InputType, char> &&
+    requires (const T& p, const std::span<const char> input) {
+        { p.scan(input) } -> std::same_as<size_t>;
+    };
+
 template <class...Parsers>
 concept CompatibleParsers = (Parser<Parsers> && ...) &&
     TypePack<typename Parsers::InputType...>::template remove_t<AnyInputType>::all_same;
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+
+namespace skarn::parser {
+
+struct ParserPosition {
+    size_t offset;
+};
+
+} // namespace skarn::parser
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "ParserContext.h"
+#include <tuple>
+#include <utility>
+
+namespace skarn::parser {
+
+enum class Associativity : uint8_t {
+    Left,
+    Right,
+};
+
+/// Operators of one level of PrecedenceParser, the parser produces the operator, e.g. a BinaryOp.
+template <details::Parser Parser>
+struct PrecedenceLevel final {
+    Parser operators;
+    Associativity associativity {Associativity::Left};
+};
+
+/// Parser of binary operations over the atom, built in one pass by precedence climbing.
+/// Levels are listed from the loosest to the tightest binding, the operators of a level are tried in the order
+/// of levels, so they should not be prefixes of the operators of later levels. The combine invocable folds
+/// the left operand with the operator and the right operand in place: combine([ctx,] lhs, op, rhs).
+/// The recursion depth grows by one per operator, not per level; an operator without a right operand
+/// is not consumed, like the tail of SequenceParser.
+template <details::Parser Atom, class Combine, details::Parser... Operators>
+requires (sizeof...(Operators) != 0 && !std::is_same_v<typename Atom::ValueType, NoValueType>)
+class PrecedenceParser final {
+    Atom atom_;
+    Combine combine_;
+    std::tuple<PrecedenceLevel<Operators>...> levels_;
+
+public:
+    using ParserType = PrecedenceParser;
+    using InputType = Atom::InputType;
+    using ValueType = Atom::ValueType;
+
+    explicit constexpr PrecedenceParser(Atom atom, Combine combine, PrecedenceLevel<Operators>... levels) noexcept
+        : atom_ {std::move(atom)}
+        , combine_ {std::move(combine)}
+        , levels_ {std::move(levels)...} {
+    }
+
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        return details::first_set_of(atom_);
+    }
+
+    bool parse(ParserContext<InputType>& ctx, ValueType& value) const {
+        return parseFrom(ctx, value, 0);
+    }
+
+    // without values precedence does not matter: atom (operator atom)*
+    bool parse(ParserContext<InputType>& ctx) const {
+        if (!atom_.parse(ctx)) {
+            return false;
+        }
+
+        const bool report_flag = ctx.report_messages();
+        ctx.report_messages(false);
+        for (;;) {
+            const ParserCheckpoint checkpoint {ctx};
+            const auto parseOperator = [&ctx, &checkpoint](const auto& level) {
+                if (level.operators.parse(ctx)) {
+                    return true;
+                }
+
+                checkpoint.restore();
+                return false;
+            };
+
+            const bool matched = std::apply([&parseOperator](const auto&... levels) {
+                return (parseOperator(levels) || ...);
+            }, levels_);
+
+            if (!matched || !atom_.parse(ctx)) {
+                checkpoint.restore();
+                break;
+            }
+        }
+
+        ctx.report_messages(report_flag);
+        return true;
+    }
+
+private:
+    // parses an operand with the operators binding at least as tight as the level
+    bool parseFrom(ParserContext<InputType>& ctx, ValueType& value, const size_t minLevel) const {
+        if (!atom_.parse(ctx, value)) {
+            return false;
+        }
+
+        const bool report_flag = ctx.report_messages();
+        ctx.report_messages(false);
+        for (bool done = false; !done;) {
+            const bool matched = [&]<size_t... Indices>(std::index_sequence<Indices...>) {
+                return (parseOperation<Indices>(ctx, value, minLevel, done) || ...);
+            }(std::index_sequence_for<Operators...> {});
+
+            done = done || !matched;
+        }
+
+        ctx.report_messages(report_flag);
+        return true;
+    }
+
+    // returns false if the operator of the level does not match, sets done if the operation is left to the caller
+    template <size_t Index>
+    bool parseOperation(ParserContext<InputType>& ctx, ValueType& value, const size_t minLevel, bool& done) const {
+        const auto& level = std::get<Index>(levels_);
+        using OperatorParser = std::tuple_element_t<Index, std::tuple<Operators...>>;
+
+        const ParserCheckpoint checkpoint {ctx};
+        typename OperatorParser::ValueType op {};
+        if (!level.operators.parse(ctx, op)) {
+            checkpoint.restore();
+            return false;
+        }
+
+        const size_t rhsLevel = level.associativity == Associativity::Left ? Index + 1 : Index;
+        ValueType rhs {};
+        if (Index < minLevel || !parseFrom(ctx, rhs, rhsLevel)) {
+            checkpoint.restore();
+            done = true;
+            return true;
+        }
+
+        if constexpr (std::invocable<const Combine&, ParserContext<InputType>&, ValueType&,
+            typename OperatorParser::ValueType&, ValueType&>) {
+            combine_(ctx, value, op, rhs);
+        }
+        else {
+            combine_(value, op, rhs);
+        }
+
+        return true;
+    }
+};
+
+} // namespace skarn::parser
@@ -79,13 +79,71 @@ public:
 template <Parser Parser>
 requires (!std::is_same_v<typename Parser::InputType, AnyInputType>)
 ParserStorage(Parser parser) -> ParserStorage<typename Parser::ValueType, typename Parser::InputType>;
+
+/// Parses a rule in the packrat mode, the result at the current offset is looked up by the rule key first.
+/// Values are cached only if they are copy constructible, failures are replayed only while they are not tracked
+/// by messages.
+template <class Value, class Input, class ParseFunction>
+bool parse_memoized(ParserContext<Input>& ctx, const void* const rule, Value* const value, const ParseFunction& parse) {
+    PackratCache& cache = *ctx.packrat_cache();
+    const ParserPosition position = ctx.position();
+    if (const PackratCache::Entry* entry = cache.find(rule, position.offset)) {
+        if (!entry->success && !ctx.track_failures()) {
+            cache.hit();
+            return false;
+        }
+
+        if (entry->success && (value == nullptr || entry->value)) {
+            if constexpr (std::is_copy_constructible_v<Value>) {
+                if (value != nullptr) {
+                    *value = *static_cast<const Value*>(entry->value.get());
+                }
+            }
+
+            ctx.position(entry->end);
+            cache.hit();
+            return true;
+        }
+    }
+
+    cache.miss();
+    const bool result = parse(ctx, value);
+    std::shared_ptr<const void> cached;
+    if constexpr (std::is_copy_constructible_v<Value>) {
+        if (result && value != nullptr) {
+            cached = std::make_shared<const Value>(*value);
+        }
+    }
+
+    cache.store(rule, position.offset, PackratCache::Entry {
+        .value = std::move(cached),
+        .end = ctx.position(),
+        .success = result,
+    });
+
+    return result;
+}
 } // namespace details
 
 /// Parser that references to another parser, allowing to build recursive parser definitions.
+/// The parser is bound at run time and called indirectly, the binding is shared by all instances of the type,
+/// so it must be assigned before parsing from several threads. RuleParser binds recursive rules at compile time,
+/// such grammars are immutable and can be parsed from any number of threads without setup.
+/// When the context is in the packrat mode, results are memoized per (reference, offset), see parse_memoized.
 template <class Value, class Input = char, class = decltype([]{})>
 class ReferenceParser final {
     inline static details::ParserStorage<Value, Input> storage_;
 
+    static void checkInitialized() {
+        if (!storage_.initialized()) {
+            throw std::logic_error {"Parser is not assigned"};
+        }
+    }
+
+    static bool parseStored(ParserContext<Input>& ctx, Value* const value) {
+        return value != nullptr ? storage_.parse(ctx, *value) : storage_.parse(ctx);
+    }
+
 public:
     using ParserType = ReferenceParser;
     using InputType = Input;
@@ -102,16 +160,18 @@ public:
 
     bool parse(ParserContext<InputType>& ctx, ValueType& value) const
     requires (!std::is_same_v<ValueType, NoValueType>) {
-        if (!storage_.initialized()) {
-            throw std::logic_error {"Parser is not assigned"};
+        checkInitialized();
+        if (ctx.packrat()) {
+            return details::parse_memoized(ctx, &storage_, &value, &parseStored);
         }
 
         return storage_.parse(ctx, value);
     }
 
     bool parse(ParserContext<InputType>& ctx) const {
-        if (!storage_.initialized()) {
-            throw std::logic_error {"Parser is not assigned"};
+        checkInitialized();
+        if (ctx.packrat()) {
+            return details::parse_memoized<Value>(ctx, &storage_, nullptr, &parseStored);
         }
 
         return storage_.parse(ctx);
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ParserContext.h"
+#include "ReferenceParser.h"
+
+namespace skarn::parser {
+
+/// Parser of a named rule, allowing to build recursive parser definitions that are bound at compile time.
+/// Rule is a type with a static constexpr member definition, a parser or a parser interface producing Value.
+/// The rule may be declared before the parsers using it and defined after them, the definition is looked up
+/// only when a parse method is instantiated, so the calls are direct and can be inlined, unlike with ReferenceParser.
+/// When the context is in the packrat mode, results are memoized per (rule, offset), see parse_memoized.
+template <class Rule, class Value, class Input = char>
+class RuleParser final {
+    inline static constexpr char key_ {};
+
+    static constexpr const auto& definition() noexcept {
+        if constexpr (requires { Rule::definition.parser(); }) {
+            return Rule::definition.parser();
+        }
+        else {
+            return Rule::definition;
+        }
+    }
+
+    static bool parseDefinition(ParserContext<Input>& ctx, Value* const value) {
+        if constexpr (!std::is_same_v<Value, NoValueType>) {
+            if (value != nullptr) {
+                return definition().parse(ctx, *value);
+            }
+        }
+
+        return definition().parse(ctx);
+    }
+
+public:
+    using ParserType = RuleParser;
+    using InputType = Input;
+    using ValueType = Value;
+
+    explicit constexpr RuleParser() noexcept = default;
+
+    bool parse(ParserContext<InputType>& ctx, ValueType& value) const
+    requires (!std::is_same_v<ValueType, NoValueType>) {
+        using Definition = std::remove_cvref_t<decltype(definition())>;
+        static_assert(std::is_same_v<Value, typename Definition::ValueType> &&
+            std::is_same_v<Input, typename Definition::InputType>, "The rule definition has another value or input type");
+
+        if (ctx.packrat()) {
+            return details::parse_memoized(ctx, &key_, &value, &parseDefinition);
+        }
+
+        return definition().parse(ctx, value);
+    }
+
+    bool parse(ParserContext<InputType>& ctx) const {
+        if (ctx.packrat()) {
+            return details::parse_memoized<Value>(ctx, &key_, nullptr, &parseDefinition);
+        }
+
+        return definition().parse(ctx);
+    }
+};
+
+} // namespace skarn::parser
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ParserContext.h"
+#include <algorithm>
 #include <limits>
 
 namespace skarn::parser {
@@ -9,6 +10,9 @@ template <details::Parser Parser, size_t RequiredCount = 0, size_t OptionalMaxCo
 class SequenceParser final {
     Parser parser_;
 
+    static constexpr size_t maxCount = OptionalMaxCount > std::numeric_limits<size_t>::max() - RequiredCount ?
+        std::numeric_limits<size_t>::max() : RequiredCount + OptionalMaxCount;
+
 public:
     using ParserType = SequenceParser;
     using InputType = Parser::InputType;
@@ -21,7 +25,16 @@ public:
         : parser_ {std::move(parser)} {
     }
 
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        const FirstSet first = details::first_set_of(parser_);
+        return FirstSet {first.chars, RequiredCount == 0 || first.nullable};
+    }
+
     bool parse(ParserContext<InputType>& ctx) const {
+        if constexpr (details::ScanParser<Parser>) {
+            return parseScan(ctx, nullptr);
+        }
+
         if constexpr (RequiredCount != 0) {
             for (size_t i = RequiredCount; i != 0; --i) {
                 if (!parser_.parse(ctx)) {
@@ -34,9 +47,9 @@ public:
         ctx.report_messages(false);
 
         for (size_t i = OptionalMaxCount; i != 0; --i) {
-            const ParserPosition position = ctx.position();
+            const ParserCheckpoint checkpoint {ctx};
             if (!parser_.parse(ctx)) {
-                ctx.position(position);
+                checkpoint.restore();
                 break;
             }
         }
@@ -48,6 +61,10 @@ public:
     // string
     bool parse(ParserContext<InputType>& ctx, std::string& value) const
     requires (std::is_same_v<typename Parser::ValueType, char>) {
+        if constexpr (details::ScanParser<Parser>) {
+            return parseScan(ctx, &value);
+        }
+
         if constexpr (RequiredCount != 0) {
             for (size_t i = RequiredCount; i != 0; --i) {
                 char val {};
@@ -63,10 +80,10 @@ public:
         ctx.report_messages(false);
 
         for (size_t i = OptionalMaxCount; i != 0; --i) {
-            const ParserPosition position = ctx.position();
+            const ParserCheckpoint checkpoint {ctx};
             char val {};
             if (!parser_.parse(ctx, val)) {
-                ctx.position(position);
+                checkpoint.restore();
                 break;
             }
 
@@ -94,11 +111,11 @@ public:
         ctx.report_messages(false);
 
         for (size_t i = OptionalMaxCount; i != 0; --i) {
-            const ParserPosition position = ctx.position();
+            const ParserCheckpoint checkpoint {ctx};
             if (typename Parser::ValueType& val = value.emplace_back();
                 !parser_.parse(ctx, val)) {
                 value.pop_back();
-                ctx.position(position);
+                checkpoint.restore();
                 break;
             }
         }
@@ -106,6 +123,43 @@ public:
         ctx.report_messages(report_flag);
         return true;
     }
+
+private:
+    // matches the whole run of characters at once instead of parsing them one by one
+    bool parseScan(ParserContext<InputType>& ctx, std::string* const value) const {
+        size_t length = 0;
+        for (;;) { // a run may continue in the next chunk of the input
+            const std::span<const char> input = ctx.input();
+            const size_t count = parser_.scan(input.first(std::min(input.size(), maxCount - length)));
+            if (value != nullptr) {
+                value->append(input.data(), count);
+            }
+
+            ctx.consume(count);
+            length += count;
+            if (count == 0 || count < input.size() || length == maxCount) {
+                break;
+            }
+        }
+
+        if (length < RequiredCount) {
+            return parser_.parse(ctx); // reports the mismatch
+        }
+
+        if (length < maxCount) {
+            const bool report_flag = ctx.report_messages();
+            ctx.report_messages(false);
+            if (ctx.track_failures()) {
+                const ParserCheckpoint checkpoint {ctx};
+                std::ignore = parser_.parse(ctx); // records the character ending the run
+                checkpoint.restore();
+            }
+
+            ctx.report_messages(report_flag);
+        }
+
+        return true;
+    }
 };
 
 } // namespace skarn::parser
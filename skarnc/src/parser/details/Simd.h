@@ -0,0 +1,11 @@
+#pragma once
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SKARN_PARSER_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define SKARN_PARSER_SSE2
+#endif
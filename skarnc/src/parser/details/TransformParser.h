@@ -40,6 +40,23 @@ template <class Result, class Arg, class Value>
 struct TransformInvocableResult<void(Result&, Arg) noexcept, Value> : std::type_identity<Result> {
 };
 
+// transforms that also receive the parser context
+template <class Type, class Input, class Result, class Arg, class Value>
+struct TransformInvocableResult<void(Type::*)(ParserContext<Input>&, Result&, Arg) const, Value> : std::type_identity<Result> {
+};
+
+template <class Type, class Input, class Result, class Arg, class Value>
+struct TransformInvocableResult<void(Type::*)(ParserContext<Input>&, Result&, Arg) const noexcept, Value> : std::type_identity<Result> {
+};
+
+template <class Input, class Result, class Arg, class Value>
+struct TransformInvocableResult<void(*)(ParserContext<Input>&, Result&, Arg), Value> : std::type_identity<Result> {
+};
+
+template <class Input, class Result, class Arg, class Value>
+struct TransformInvocableResult<void(*)(ParserContext<Input>&, Result&, Arg) noexcept, Value> : std::type_identity<Result> {
+};
+
 template <class F, class Value>
 requires (requires { &F::operator(); })
 struct TransformInvocableResult<F, Value> : TransformInvocableResult<decltype(&F::operator()), Value> {
@@ -55,9 +72,18 @@ concept TransformInvocable =
     requires (const T& t, typename TransformInvocableResult<T, Value>::type& result, Value& value) {
     { t(result, value) } -> std::same_as<void>;
     };
+
+template <class T, class Value, class Input>
+concept ContextTransformInvocable =
+    requires (const T& t, ParserContext<Input>& ctx, typename TransformInvocableResult<T, Value>::type& result, Value& value) {
+    { t(ctx, result, value) } -> std::same_as<void>;
+    };
 } // namespace details
 
-template <details::Parser Parser, details::TransformInvocable<typename Parser::ValueType> Transform>
+/// Parser that converts the value of the parser, the transform may take the parser context as the first argument.
+template <details::Parser Parser, class Transform>
+requires (details::TransformInvocable<Transform, typename Parser::ValueType> ||
+    details::ContextTransformInvocable<Transform, typename Parser::ValueType, typename Parser::InputType>)
 class TransformParser final {
     Parser parser_;
     Transform transform_;
@@ -72,11 +98,21 @@ public:
         , transform_ {std::move(transform)} {
     }
 
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        return details::first_set_of(parser_);
+    }
+
     bool parse(ParserContext<InputType>& ctx, ValueType& value) const
     requires (!std::is_same_v<ValueType, NoValueType>) {
         if (typename Parser::ValueType val {};
             parser_.parse(ctx, val)) {
-            transform_(value, val);
+            if constexpr (details::ContextTransformInvocable<Transform, typename Parser::ValueType, InputType>) {
+                transform_(ctx, value, val);
+            }
+            else {
+                transform_(value, val);
+            }
+
             return true;
         }
 
@@ -19,6 +19,10 @@ public:
         , value_ {std::move(value)} {
     }
 
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        return details::first_set_of(parser_);
+    }
+
     bool parse(ParserContext<InputType>& ctx, Value& value) const
     requires (!std::is_same_v<Value, NoValueType>) {
         if (parser_.parse(ctx)) {
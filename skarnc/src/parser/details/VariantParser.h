@@ -1,11 +1,49 @@
 #pragma once
 
 #include "ParserContext.h"
+#include <array>
+#include <cstdint>
 #include <tuple>
 #include <variant>
 
 namespace skarn::parser {
 
+namespace details {
+template <size_t Count>
+using DispatchMask =
+    std::conditional_t<Count <= 8, uint8_t,
+    std::conditional_t<Count <= 16, uint16_t,
+    std::conditional_t<Count <= 32, uint32_t, uint64_t>>>;
+
+/// Alternatives that can start with a given character, computed from their FIRST sets.
+template <size_t Count>
+requires (Count <= 64)
+struct DispatchTable {
+    using Mask = DispatchMask<Count>;
+
+    std::array<Mask, 256> masks {};
+    Mask end_of_input {}; // alternatives that can succeed at the end of input
+
+    constexpr void add(const size_t index, const FirstSet& first) noexcept {
+        const auto bit = static_cast<Mask>(uint64_t {1} << index);
+        for (unsigned chr = 0; chr != 256; ++chr) {
+            if (first.nullable || first.chars.contains(static_cast<char>(chr))) {
+                masks[chr] |= bit;
+            }
+        }
+
+        if (first.nullable) {
+            end_of_input |= bit;
+        }
+    }
+};
+
+struct NoDispatchTable final {
+};
+} // namespace details
+
+/// Ordered choice. For character input, alternatives that cannot start with the next character are skipped
+/// using a table built from FIRST sets, unless their failures are tracked by messages.
 template <details::Parser...Parsers>
 requires (sizeof...(Parsers) >= 2 && details::CompatibleParsers<Parsers...>)
 class VariantParser final {
@@ -14,6 +52,30 @@ class VariantParser final {
     template <size_t Index>
     using ParserValueType = TypePack<typename Parsers::ValueType...>::template element_t<Index>;
 
+    static constexpr size_t lastIndex = sizeof...(Parsers) - 1;
+    static constexpr bool useDispatch =
+        std::is_same_v<details::InputTypeOf<Parsers...>, char> && sizeof...(Parsers) <= 64;
+
+    using DispatchTable = std::conditional_t<useDispatch,
+        details::DispatchTable<sizeof...(Parsers)>, details::NoDispatchTable>;
+    using DispatchMask = details::DispatchMask<sizeof...(Parsers)>;
+
+    static constexpr DispatchMask allAlternatives = static_cast<DispatchMask>(
+        sizeof...(Parsers) >= 64 ? ~uint64_t {} : (uint64_t {1} << sizeof...(Parsers)) - 1);
+
+    [[no_unique_address]] DispatchTable dispatch_;
+
+    static constexpr DispatchTable makeDispatchTable(const std::tuple<Parsers...>& parsers) noexcept {
+        DispatchTable table {};
+        if constexpr (useDispatch) {
+            [&table, &parsers]<size_t...Indices>(const std::index_sequence<Indices...>) constexpr noexcept {
+                (table.add(Indices, details::first_set_of(std::get<Indices>(parsers))), ...);
+            }(std::make_index_sequence<sizeof...(Parsers)>());
+        }
+
+        return table;
+    }
+
 public:
     using ParserType = VariantParser;
     using InputType = details::InputTypeOf<Parsers...>;
@@ -24,8 +86,29 @@ public:
         typename ValueTypePack::template replace_t<NoValueType, std::monostate>::template apply_to_t<std::variant>>;
 
 private:
+    /// Mask of the alternatives worth trying at the current position.
+    DispatchMask candidates(ParserContext<InputType>& ctx) const {
+        if constexpr (useDispatch) {
+            if (!ctx.track_failures()) {
+                const std::span<const char> input = ctx.input();
+                return input.empty() ? dispatch_.end_of_input : dispatch_.masks[static_cast<unsigned char>(input[0])];
+            }
+        }
+
+        return allAlternatives;
+    }
+
+    template <size_t Index>
+    static constexpr bool contains(const DispatchMask mask) noexcept {
+        if constexpr (useDispatch) {
+            return (mask >> Index & 1U) != 0;
+        }
+        else {
+            return true;
+        }
+    }
+
     bool parseLastVariant(ParserContext<InputType>& ctx, ValueType& value) const {
-        constexpr size_t lastIndex = sizeof...(Parsers) - 1;
         const auto& parser = std::get<lastIndex>(parsers_);
         using Value = ParserValueType<lastIndex>;
         if constexpr (std::is_same_v<ValueType, NoValueType>) {
@@ -45,39 +128,38 @@ private:
     }
 
     bool parseLastVariant(ParserContext<InputType>& ctx) const {
-        constexpr size_t lastIndex = sizeof...(Parsers) - 1;
         const auto& parser = std::get<lastIndex>(parsers_);
         return parser.parse(ctx);
     }
 
     template <size_t Index>
     bool parseVariant(ParserContext<InputType>& ctx, ValueType& value) const {
-        const ParserPosition position = ctx.position();
+        const ParserCheckpoint checkpoint {ctx};
         using Value = ParserValueType<Index>;
         const auto& parser = std::get<Index>(parsers_);
         if constexpr (std::is_same_v<ValueType, NoValueType>) {
             if (!parser.parse(ctx)) {
-                ctx.position(position);
+                checkpoint.restore();
                 return false;
             }
         }
         else if constexpr (!SpecializationOf<ValueType, std::variant>) {
             if (!parser.parse(ctx, value)) {
-                ctx.position(position);
+                checkpoint.restore();
                 return false;
             }
         }
         else if constexpr (std::is_same_v<Value, NoValueType>) {
             value.template emplace<std::monostate>();
             if (!parser.parse(ctx)) {
-                ctx.position(position);
+                checkpoint.restore();
                 return false;
             }
         }
         else {
             auto& val = value.template emplace<Value>();
             if (!parser.parse(ctx, val)) {
-                ctx.position(position);
+                checkpoint.restore();
                 return false;
             }
         }
@@ -87,11 +169,11 @@ private:
 
     template <size_t Index>
     bool parseVariant(ParserContext<InputType>& ctx) const {
-        const ParserPosition position = ctx.position();
+        const ParserCheckpoint checkpoint {ctx};
 
         if (const auto& parser = std::get<Index>(parsers_);
             !parser.parse(ctx)) {
-            ctx.position(position);
+            checkpoint.restore();
             return false;
         }
 
@@ -103,10 +185,20 @@ private:
         const bool report_flag = ctx.report_messages();
         ctx.report_messages(false);
 
-        const bool result = (parseVariant<Indices>(ctx, value) || ...);
+        const DispatchMask mask = candidates(ctx);
+        const bool result = ((contains<Indices>(mask) && parseVariant<Indices>(ctx, value)) || ...);
         ctx.report_messages(report_flag);
 
-        return result || parseLastVariant(ctx, value);
+        if (result) {
+            return true;
+        }
+
+        // the last alternative reports the failure, it is only skipped if nobody observes the failure
+        if (!contains<lastIndex>(mask) && !ctx.track_failures()) {
+            return false;
+        }
+
+        return parseLastVariant(ctx, value);
     }
 
     template <size_t...Indices>
@@ -114,21 +206,40 @@ private:
         const bool report_flag = ctx.report_messages();
         ctx.report_messages(false);
 
-        const bool result = (parseVariant<Indices>(ctx) || ...);
+        const DispatchMask mask = candidates(ctx);
+        const bool result = ((contains<Indices>(mask) && parseVariant<Indices>(ctx)) || ...);
         ctx.report_messages(report_flag);
 
-        return result || parseLastVariant(ctx);
+        if (result) {
+            return true;
+        }
+
+        if (!contains<lastIndex>(mask) && !ctx.track_failures()) {
+            return false;
+        }
+
+        return parseLastVariant(ctx);
     }
 
 public:
     explicit constexpr VariantParser(Parsers... parsers) noexcept
-        : parsers_ {std::move(parsers)...} {
+        : parsers_ {std::move(parsers)...}
+        , dispatch_ {makeDispatchTable(parsers_)} {
     }
 
     [[nodiscard]] constexpr const std::tuple<Parsers...>& parsers() const noexcept {
         return parsers_;
     }
 
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        return std::apply([](const Parsers&...parsers) constexpr noexcept {
+            FirstSet result {CharSet {}, false};
+            ((result.chars |= details::first_set_of(parsers).chars), ...);
+            result.nullable = (details::first_set_of(parsers).nullable || ...);
+            return result;
+        }, parsers_);
+    }
+
     bool parse(ParserContext<InputType>& ctx, ValueType& value) const
     requires (!std::is_same_v<ValueType, NoValueType>) {
         return parseImpl(ctx, value, std::make_index_sequence<sizeof...(Parsers) - 1>());
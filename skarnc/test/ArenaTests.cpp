@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "Arena.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace skarn;
+
+TEST(ArenaTests, Alignment)
+{
+    Arena arena {64};
+    std::ignore = arena.allocate(1, 1);
+    const void* const ptr = arena.allocate(8, 8);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 8, 0U);
+
+    struct Pair {
+        int64_t first;
+        int32_t second;
+    };
+
+    const Pair* const pair = arena.create<Pair>(1, 2);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pair) % alignof(Pair), 0U);
+    EXPECT_EQ(pair->first, 1);
+    EXPECT_EQ(pair->second, 2);
+    EXPECT_EQ(arena.allocated(), 1 + 8 + sizeof(Pair));
+}
+
+TEST(ArenaTests, Blocks)
+{
+    Arena arena {64};
+    EXPECT_EQ(arena.block_count(), 0U);
+
+    std::ignore = arena.allocate(48);
+    EXPECT_EQ(arena.block_count(), 1U);
+
+    std::ignore = arena.allocate(48);
+    EXPECT_EQ(arena.block_count(), 2U);
+
+    std::ignore = arena.allocate(1000); // larger than a block
+    EXPECT_EQ(arena.block_count(), 3U);
+}
+
+TEST(ArenaTests, Copy)
+{
+    Arena arena;
+    std::string str {"name"};
+    const std::string_view copy = arena.copy(str);
+    str[0] = 'x';
+    EXPECT_EQ(copy, "name"sv);
+    EXPECT_TRUE(arena.copy({}).empty());
+}
+
+TEST(ArenaTests, CopyArray)
+{
+    Arena arena;
+    const std::vector<int> values {1, 2, 3};
+    const std::span<int> copy = arena.copy_array(values);
+    ASSERT_EQ(copy.size(), 3U);
+    EXPECT_NE(copy.data(), values.data());
+    EXPECT_TRUE(std::ranges::equal(copy, values));
+    EXPECT_TRUE(arena.copy_array(std::vector<int> {}).empty());
+}
+
+TEST(ArenaTests, Merge)
+{
+    Arena arena {64};
+    std::ignore = arena.allocate(16);
+
+    Arena other {64};
+    const std::string_view copy = other.copy("name"sv);
+    std::ignore = other.allocate(100);
+
+    arena.merge(std::move(other));
+    EXPECT_EQ(arena.block_count(), 3U);
+    EXPECT_EQ(arena.allocated(), 16 + 4 + 100U);
+    EXPECT_EQ(copy, "name"sv);
+    EXPECT_EQ(other.block_count(), 0U);
+    EXPECT_EQ(other.allocated(), 0U);
+
+    std::ignore = arena.allocate(16); // still in the first block
+    EXPECT_EQ(arena.block_count(), 3U);
+}
+
+TEST(ArenaTests, Move)
+{
+    Arena arena {64};
+    const std::string_view copy = arena.copy("name"sv);
+
+    Arena target {std::move(arena)};
+    EXPECT_EQ(target.block_count(), 1U);
+    EXPECT_EQ(target.allocated(), 4U);
+    EXPECT_EQ(arena.block_count(), 0U);
+    EXPECT_EQ(arena.allocated(), 0U);
+
+    // the moved-from arena does not write into the block of the target
+    const std::string_view other = arena.copy("other"sv);
+    EXPECT_EQ(arena.block_count(), 1U);
+    EXPECT_EQ(copy, "name"sv);
+    EXPECT_EQ(other, "other"sv);
+
+    Arena assigned {64};
+    std::ignore = assigned.allocate(16);
+    assigned = std::move(target);
+    EXPECT_EQ(assigned.block_count(), 1U);
+    EXPECT_EQ(assigned.allocated(), 4U);
+    EXPECT_EQ(target.block_count(), 0U);
+    EXPECT_EQ(target.allocated(), 0U);
+
+    std::ignore = target.allocate(32);
+    EXPECT_EQ(target.block_count(), 1U);
+    EXPECT_EQ(copy, "name"sv);
+}
@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+#include "Arithmetic.h"
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+
+using namespace skarn;
+
+namespace {
+constexpr int64_t min = std::numeric_limits<int64_t>::min();
+constexpr int64_t max = std::numeric_limits<int64_t>::max();
+} // namespace
+
+TEST(ArithmeticTests, Wrapping)
+{
+    static_assert(wrapping_add(max, 1) == min);
+    static_assert(wrapping_subtract(min, 1) == max);
+    static_assert(wrapping_multiply(max, 2) == -2);
+    static_assert(wrapping_multiply(min, -1) == min);
+    static_assert(wrapping_negate(min) == min);
+    static_assert(wrapping_negate(5) == -5);
+    static_assert(wrapping_add(-3, 7) == 4);
+}
+
+TEST(ArithmeticTests, Divide)
+{
+    static_assert(wrapping_divide(7, 2) == 3);
+    static_assert(wrapping_divide(-7, 2) == -3);
+    static_assert(wrapping_divide(7, -1) == -7);
+    static_assert(wrapping_divide(min, -1) == min);
+    EXPECT_THROW(std::ignore = wrapping_divide(1, 0), std::runtime_error);
+}
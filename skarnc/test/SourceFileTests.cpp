@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "SourceFile.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace std::string_view_literals;
+using namespace skarn;
+
+namespace {
+std::filesystem::path write_file(const std::string_view name, const std::string_view text) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    std::ofstream file {path, std::ios::binary};
+    file << text;
+    return path;
+}
+} // namespace
+
+TEST(SourceFileTests, MapsRegularFile)
+{
+    const std::filesystem::path path = write_file("skarn_source_file_test.sk", "fn main() {\n    1\n}\n"sv);
+    {
+        std::optional<SourceFile> file = SourceFile::open(path);
+        ASSERT_TRUE(file);
+        EXPECT_TRUE(file->mapped());
+
+        const SourceFile moved {std::move(*file)};
+        EXPECT_EQ(moved.text(), "fn main() {\n    1\n}\n"sv);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(SourceFileTests, EmptyFile)
+{
+    const std::filesystem::path path = write_file("skarn_source_file_empty_test.sk", ""sv);
+    {
+        const std::optional<SourceFile> file = SourceFile::open(path);
+        ASSERT_TRUE(file);
+        EXPECT_FALSE(file->mapped());
+        EXPECT_TRUE(file->text().empty());
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(SourceFileTests, MissingFile)
+{
+    EXPECT_FALSE(SourceFile::open(std::filesystem::temp_directory_path() / "skarn_source_file_missing.sk"));
+}
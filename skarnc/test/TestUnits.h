@@ -0,0 +1,148 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "ast/Parser.h"
+#include "ast/SlotResolver.h"
+#include "ast/TypeInference.h"
+#include <string_view>
+#include <utility>
+
+/// Units shared by the tests of the analysis passes and the execution engines.
+namespace skarn::test {
+
+/// Parses the unit, a parse error fails the current test and yields an empty unit.
+inline ast::Unit parse_unresolved(const std::string_view source) {
+    auto unit = ast::parse_unit(source);
+    if (!unit) {
+        ADD_FAILURE() << "expected " << unit.error().front().expected << " at " << unit.error().front().line << ":"
+            << unit.error().front().column;
+        return {};
+    }
+
+    return std::move(*unit);
+}
+
+/// Parses the unit and resolves its slots, as the execution engines expect.
+inline ast::Unit parse(const std::string_view source) {
+    ast::Unit unit = parse_unresolved(source);
+    ast::resolve_slots(unit);
+    return unit;
+}
+
+/// Parses the unit, resolves its slots and infers its types.
+inline ast::Unit infer(const std::string_view source) {
+    ast::Unit unit = parse(source);
+    ast::infer_types(unit);
+    return unit;
+}
+
+/// Iterative Fibonacci numbers, main prints "fib(5)=5".
+constexpr std::string_view fibSource = R"(
+    fn fib(n) {
+        let a = 0;
+        let b = 1;
+        let i = 0;
+        while i < n {
+            let tmp = a;
+            a = b;
+            b = tmp + a;
+            i = i + 1;
+        }
+
+        a
+    }
+
+    fn main() {
+        let n = 5;
+        println("fib({})={}", n, fib(n));
+    }
+)";
+
+constexpr std::string_view recursiveFibSource = R"(
+    fn fib(n) {
+        while n < 2 {
+            return n;
+        }
+
+        fib(n - 1) + fib(n - 2)
+    }
+)";
+
+/// Returns from nested loops, reassigns arguments and prints, for comparing the engines with the interpreter.
+constexpr std::string_view mixSource = R"(
+    fn first_square_above(limit) {
+        let i = 0;
+        while 1 {
+            while i * i > limit {
+                return i;
+            }
+
+            i = i + 1;
+        }
+
+        0 - 1
+    }
+
+    fn mix(a, b, c) {
+        let x = a - b - c;
+        x = -x * (b + 1) / 2;
+        println("{} {} {{}}", x, a >= b);
+        b = a;
+        a = c;
+        (a + b) * x - mix_args(c, b, a)
+    }
+
+    fn mix_args(a, b, c) {
+        a * 100 + b * 10 + c
+    }
+
+    fn main() {
+        -first_square_above(50) * 2 + (3 - 1) / 2 + mix(7, 2, 1) + mix(1, 2, mix(3, 4, 5))
+    }
+)";
+
+/// Prints the arguments of println evaluated for their side effects, the last one is not formatted.
+constexpr std::string_view printlnArgumentsSource = R"(
+    fn side_effect(x) {
+        println("side effect {}", x);
+        x
+    }
+
+    fn main() {
+        println("{}", side_effect(1), side_effect(2));
+        0
+    }
+)";
+
+/// Prints INT64_MIN, INT64_MIN - 1, -INT64_MIN and INT64_MIN / -1, main returns INT64_MIN * 4.
+constexpr std::string_view overflowSource = R"(
+    fn min() {
+        let x = 1;
+        let i = 0;
+        while i < 63 {
+            x = x * 2;
+            i = i + 1;
+        }
+
+        x
+    }
+
+    fn main() {
+        let x = min();
+        println("{} {} {} {}", x, x - 1, -x, x / (0 - 1));
+        x * 3 + x
+    }
+)";
+
+/// countdown(n) makes n + 1 nested calls.
+constexpr std::string_view countdownSource = R"(
+    fn countdown(n) {
+        while n > 0 {
+            return countdown(n - 1);
+        }
+
+        n
+    }
+)";
+
+} // namespace skarn::test
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace skarn;
+
+TEST(ThreadPoolTests, Indices)
+{
+    ThreadPool pool {4};
+    for (const size_t count : {size_t {0}, size_t {1}, ThreadPool::min_parallel_count, size_t {10'000}}) {
+        std::vector<std::atomic<int>> visits(count);
+        std::atomic<bool> valid_workers {true};
+        pool.parallel_for(count, [&](const size_t index, const size_t worker) {
+            visits[index].fetch_add(1);
+            if (worker >= pool.thread_count()) {
+                valid_workers = false;
+            }
+        });
+
+        EXPECT_TRUE(std::ranges::all_of(visits, [](const std::atomic<int>& visit) { return visit == 1; })) << count;
+        EXPECT_TRUE(valid_workers) << count;
+    }
+}
+
+TEST(ThreadPoolTests, Stealing)
+{
+    ThreadPool pool {4};
+    constexpr size_t count = 256;
+    std::vector<size_t> workers(count);
+    pool.parallel_for(count, [&workers](const size_t index, const size_t worker) {
+        if (index < count / 4) {
+            std::this_thread::sleep_for(std::chrono::milliseconds {1}); // the first range is slow
+        }
+
+        workers[index] = worker;
+    });
+
+    EXPECT_TRUE(std::ranges::any_of(workers.begin(), workers.begin() + count / 4, [](const size_t worker) { return worker != 0; }));
+}
+
+TEST(ThreadPoolTests, WorkerState)
+{
+    ThreadPool pool {3};
+    std::vector<size_t> sums(pool.thread_count());
+    pool.parallel_for(1000, [&sums](const size_t index, const size_t worker) {
+        sums[worker] += index; // a worker runs its tasks one by one
+    });
+
+    EXPECT_EQ(std::accumulate(sums.begin(), sums.end(), size_t {}), 999U * 1000 / 2);
+}
+
+TEST(ThreadPoolTests, Errors)
+{
+    ThreadPool pool {4};
+    for (int i = 0; i < 10; ++i) {
+        try {
+            pool.parallel_for(1000, [](const size_t index, size_t) {
+                if (index % 100 == 42) {
+                    throw std::runtime_error {std::to_string(index)};
+                }
+            });
+            ADD_FAILURE() << "expected an exception";
+        }
+        catch (const std::runtime_error& e) {
+            EXPECT_STREQ(e.what(), "42");
+        }
+    }
+
+    size_t count = 0;
+    pool.parallel_for(100, [&count](size_t, size_t) {
+        static std::mutex mutex;
+        const std::lock_guard lock {mutex};
+        ++count;
+    });
+    EXPECT_EQ(count, 100U);
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "TestUnits.h"
+#include "ast/Analysis.h"
+#include "bytecode/Compiler.h"
+#include "bytecode/Disassembler.h"
+#include <format>
+#include <string>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace skarn;
+using namespace skarn::ast;
+using namespace skarn::test;
+
+namespace {
+/// Functions calling the previous one, each shadows a variable.
+std::string synthetic_source(const size_t count) {
+    std::string source;
+    for (size_t i = 0; i < count; ++i) {
+        source += std::format(R"(
+            fn f{0}(n) {{
+                let a = n * {0} + 2 * 3;
+                let i = 0;
+                while i < n {{
+                    let a = a + 1 + 1;
+                    i = i + a - a + 1;
+                }}
+
+                println("f{0}: {{}}", a);
+                {1}
+            }}
+        )", i, i == 0 ? std::string {"a"} : std::format("a + f{}(n - 1)", i - 1));
+    }
+
+    return source;
+}
+
+std::vector<std::string> analyze_sequentially(Unit& unit) {
+    std::vector<std::string> warnings = resolve_slots(unit);
+    infer_types(unit);
+    fold_constants(unit);
+    return warnings;
+}
+} // namespace
+
+TEST(AnalysisTests, SameAsSequential)
+{
+    const std::string source = synthetic_source(300);
+    Unit sequential = parse_unresolved(source);
+    Unit parallel = parse_unresolved(source);
+
+    ThreadPool pool {4};
+    const std::vector<std::string> warnings = analyze(parallel, pool);
+    EXPECT_EQ(warnings, analyze_sequentially(sequential));
+    ASSERT_EQ(warnings.size(), 300U);
+    EXPECT_EQ(warnings[1], "shadowed variable 'a' in function 'f1'");
+
+    const bytecode::Program program = bytecode::compile(parallel, pool);
+    EXPECT_EQ(program.strings.size(), 300U);
+    EXPECT_EQ(bytecode::disassemble(program), bytecode::disassemble(bytecode::compile(sequential)));
+}
+
+TEST(AnalysisTests, Errors)
+{
+    ThreadPool pool {4};
+    for (int i = 0; i < 10; ++i) {
+        Unit unit = parse_unresolved(synthetic_source(200) + "fn g() { x } fn h() { y }");
+        try {
+            std::ignore = analyze(unit, pool);
+            ADD_FAILURE() << "expected an exception";
+        }
+        catch (const std::runtime_error& e) {
+            EXPECT_STREQ(e.what(), "undefined variable 'x' in function 'g'");
+        }
+    }
+}
+
@@ -1,13 +1,19 @@
 #include "parser/Parser.h"
+#include "ast/Parser.h"
 #include "ast/Unit.h"
 #include <algorithm>
+#include <atomic>
 #include <gtest/gtest.h>
+#include <thread>
+#include <string>
+#include <vector>
 
 #include "TypeName.h"
 
 using namespace std::string_view_literals;
 using namespace skarn::ast;
 using namespace skarn::parser;
+using skarn::Arena;
 
 namespace {
 constexpr auto ws_many = *~Parse::ws();
@@ -33,17 +39,20 @@ constexpr auto compare_op =
     Parse::literal(">="sv).value(BinaryOp::GreaterThanOrEqual) ||
     Parse::literal(">"sv).value(BinaryOp::GreaterThan);
 
-constexpr auto ident = Parse::char_([](const char c) static noexcept {
+constexpr auto ident = (Parse::char_([](const char c) static noexcept {
         return c >= 'a' && c <= 'z' || c >= 'A' && c <= 'Z' || c == '_';
     }, "identifier"sv) >>
     *Parse::char_([](const char c) static noexcept {
         return c >= 'a' && c <= 'z' || c >= 'A' && c <= 'Z' || c >= '0' && c <= '9' || c == '_';
-    }, "identifier"sv) >>
-    [](std::string& result, std::tuple<char, std::string>& value) static {
-        result = std::get<0>(value) + std::move(std::get<1>(value));
+    }, "identifier"sv)).capture() >>
+    [](ParserContext<char>& ctx, Symbol& result, const std::string_view name) static {
+        result = ctx.user_data<SymbolTable>().intern(name);
     };
 
-constexpr auto expressionRef = Parse::ref<Expression>();
+struct ExpressionRule;
+struct StatementRule;
+
+constexpr auto expressionRef = Parse::rule<ExpressionRule, Expression>();
 
 constexpr auto constantExpression =
     Parse::integer<int>() >>
@@ -52,8 +61,8 @@ constexpr auto constantExpression =
     };
 
 constexpr auto variableExpression =
-    ident >> [](Expression& result, std::string& value) static {
-        result = Expression::variable(std::move(value));
+    ident >> [](Expression& result, const Symbol value) static {
+        result = Expression::variable(value);
     };
 
 constexpr auto bracketExpression =
@@ -63,7 +72,7 @@ constexpr auto functionCallExpression =
     ident >> ws_many >> ~Parse::char_('(') >> ws_many >>
     (expressionRef >> *(ws_many >> ~Parse::char_(',') >> ws_many >> expressionRef)).optional() >> ws_many >>
     ~Parse::char_(')') >>
-    [](Expression& result, std::tuple<std::string, std::optional<std::tuple<Expression, std::vector<Expression>>>>& value) {
+    [](ParserContext<char>& ctx, Expression& result, std::tuple<Symbol, std::optional<std::tuple<Expression, std::vector<Expression>>>>& value) {
         std::vector<Expression> args;
         if (std::optional<std::tuple<Expression, std::vector<Expression>>>& args_value = std::get<1>(value)) {
             args.push_back(std::move(std::get<0>(args_value.value())));
@@ -72,13 +81,13 @@ constexpr auto functionCallExpression =
             }
         }
 
-        result = Expression::function(std::move(std::get<0>(value)), std::move(args));
+        result = Expression::function(ctx.user_data<Arena>(), std::get<0>(value), args);
     };
 
 constexpr auto simpleExpression = constantExpression || functionCallExpression || variableExpression || bracketExpression;
 
 constexpr auto unaryExpression = *(ws_many >> unary_op) >> ws_many >> simpleExpression >>
-    [](Expression& result, std::tuple<std::vector<UnaryOp>, Expression>& value) static {
+    [](ParserContext<char>& ctx, Expression& result, std::tuple<std::vector<UnaryOp>, Expression>& value) static {
         const std::vector<UnaryOp>& ops = std::get<0>(value);
         const size_t minusCount = std::ranges::count_if(ops, [](const UnaryOp op) static noexcept {
             return op == UnaryOp::Minus;
@@ -88,50 +97,50 @@ constexpr auto unaryExpression = *(ws_many >> unary_op) >> ws_many >> simpleExpr
             result = std::move(std::get<1>(value));
         }
         else {
-            result = Expression::unary(UnaryOp::Minus, std::move(std::get<1>(value)));
+            result = Expression::unary(ctx.user_data<Arena>(), UnaryOp::Minus, std::move(std::get<1>(value)));
         }
     };
 
 constexpr auto productExpression =
     unaryExpression >> ws_many >> *(ws_many >> product_op >> ws_many >> unaryExpression) >>
-    [](Expression& result, std::tuple<Expression, std::vector<std::tuple<BinaryOp, Expression>>>& value) static {
+    [](ParserContext<char>& ctx, Expression& result, std::tuple<Expression, std::vector<std::tuple<BinaryOp, Expression>>>& value) static {
         result = std::move(std::get<0>(value));
         for (auto& [op, arg] : std::get<1>(value)) {
-            result = Expression::binary(op, std::move(result), std::move(arg));
+            result = Expression::binary(ctx.user_data<Arena>(), op, std::move(result), std::move(arg));
         }
     };
 
 constexpr auto sumExpression =
     productExpression >> ws_many >> *(ws_many >> sum_op >> ws_many >> productExpression) >>
-    [](Expression& result, std::tuple<Expression, std::vector<std::tuple<BinaryOp, Expression>>>& value) static {
+    [](ParserContext<char>& ctx, Expression& result, std::tuple<Expression, std::vector<std::tuple<BinaryOp, Expression>>>& value) static {
         result = std::move(std::get<0>(value));
         for (auto& [op, arg] : std::get<1>(value)) {
-            result = Expression::binary(op, std::move(result), std::move(arg));
+            result = Expression::binary(ctx.user_data<Arena>(), op, std::move(result), std::move(arg));
         }
     };
 
 constexpr auto expression =
     (sumExpression >> ws_many >> *(ws_many >> compare_op >> ws_many >> sumExpression) >>
-    [](Expression& result, std::tuple<Expression, std::vector<std::tuple<BinaryOp, Expression>>>& value) static {
+    [](ParserContext<char>& ctx, Expression& result, std::tuple<Expression, std::vector<std::tuple<BinaryOp, Expression>>>& value) static {
         result = std::move(std::get<0>(value));
         for (auto& [op, arg] : std::get<1>(value)) {
-            result = Expression::binary(op, std::move(result), std::move(arg));
+            result = Expression::binary(ctx.user_data<Arena>(), op, std::move(result), std::move(arg));
         }
     }).expected("expression"sv);
 
-constexpr auto statementRef = Parse::ref<Statement>();
+constexpr auto statementRef = Parse::rule<StatementRule, Statement>();
 
 constexpr auto variableDeclaration =
     ~Parse::literal("let"sv) >> ws_at_least_once >> ident >> ws_many >>
     ~Parse::char_('=') >> ws_many >> expressionRef >> ws_many >> ~Parse::char_(';') >>
-    [](Statement& result, std::tuple<std::string, Expression>& value) static {
-        result = Statement::variableDeclaration(std::move(std::get<0>(value)), std::move(std::get<1>(value)));
+    [](Statement& result, std::tuple<Symbol, Expression>& value) static {
+        result = Statement::variableDeclaration(std::get<0>(value), std::move(std::get<1>(value)));
     };
 
 constexpr auto variableAssignment =
     ident >> ws_many >> ~Parse::char_('=') >> ws_many >> expressionRef >> ws_many >> ~Parse::char_(';') >>
-    [](Statement& result, std::tuple<std::string, Expression>& value) static {
-        result = Statement::variableAssignment(std::move(std::get<0>(value)), std::move(std::get<1>(value)));
+    [](Statement& result, std::tuple<Symbol, Expression>& value) static {
+        result = Statement::variableAssignment(std::get<0>(value), std::move(std::get<1>(value)));
     };
 
 constexpr auto returnStatement =
@@ -150,15 +159,23 @@ constexpr auto whileStatement =
 
 constexpr auto statement = returnStatement || variableDeclaration || variableAssignment || whileStatement;
 
+struct ExpressionRule {
+    static constexpr auto definition = expression;
+};
+
+struct StatementRule {
+    static constexpr auto definition = statement;
+};
+
 constexpr auto function =
     ~Parse::literal("fn"sv) >> ws_at_least_once >> ident >> ws_many >>
     ~Parse::char_('(') >> ws_many >> ident.seq(ws_many >> ',' >> ws_many) >> ws_many >> ~Parse::char_(')') >> ws_many >>
     ~Parse::char_('{') >> ws_many >> *(statementRef >> ws_many) >> expressionRef.optional() >> ws_many >> ~Parse::char_('}') >>
-    [](Function& result, std::tuple<std::string, std::vector<std::string>, std::vector<Statement>, std::optional<Expression>>& value) static {
+    [](Function& result, std::tuple<Symbol, std::vector<Symbol>, std::vector<Statement>, std::optional<Expression>>& value) static {
         result.name = std::get<0>(value);
-        for (std::string& arg : std::get<1>(value)) {
+        for (const Symbol arg : std::get<1>(value)) {
             result.arguments.push_back(FunctionArgument {
-                .name = std::move(arg),
+                .name = arg,
             });
         }
 
@@ -171,53 +188,62 @@ constexpr auto unit = ws_many >> *(function >> ws_many) >>
         result.functions = std::move(value);
     };
 
+template <class Parser>
+auto parse(const ParserInterface<Parser>& parser, const std::string_view text, SymbolTable& symbols, Arena& arena) {
+    ParserContext<char> ctx {text};
+    ctx.user_data(symbols);
+    ctx.user_data(arena);
+    return parser.parse(ctx);
+}
 } // namespace
 
 TEST(AstParserTests, ParseSimpleExpression) {
-    expressionRef.assign(expression);
+    SymbolTable symbols;
+    Arena arena;
 
-    auto result = expression.parse("a + b * (2 + c / f(4, d, g(1))) + 5 * -7 >= 1");
+    auto result = parse(expression, "a + b * (2 + c / f(4, d, g(1))) + 5 * -7 >= 1", symbols, arena);
     ASSERT_TRUE(result);
 
     const Expression& value = result.value();
     const Expression expected =
-        Expression::binary(BinaryOp::GreaterThanOrEqual,
-            Expression::binary(BinaryOp::Add,
-                Expression::binary(BinaryOp::Add,
-                    Expression::variable("a"),
-                    Expression::binary(BinaryOp::Multiply,
-                        Expression::variable("b"),
-                        Expression::binary(BinaryOp::Add,
+        Expression::binary(arena, BinaryOp::GreaterThanOrEqual,
+            Expression::binary(arena, BinaryOp::Add,
+                Expression::binary(arena, BinaryOp::Add,
+                    Expression::variable(symbols.intern("a")),
+                    Expression::binary(arena, BinaryOp::Multiply,
+                        Expression::variable(symbols.intern("b")),
+                        Expression::binary(arena, BinaryOp::Add,
                             Expression::constant(2),
-                            Expression::binary(BinaryOp::Divide,
-                                Expression::variable("c"),
-                                Expression::function("f",
+                            Expression::binary(arena, BinaryOp::Divide,
+                                Expression::variable(symbols.intern("c")),
+                                Expression::function(arena, symbols.intern("f"),
                                     Expression::constant(4),
-                                    Expression::variable("d"),
-                                    Expression::function("g",
+                                    Expression::variable(symbols.intern("d")),
+                                    Expression::function(arena, symbols.intern("g"),
                                         Expression::constant(1))))))),
-                Expression::binary(BinaryOp::Multiply,
+                Expression::binary(arena, BinaryOp::Multiply,
                     Expression::constant(5),
-                    Expression::unary(UnaryOp::Minus,
+                    Expression::unary(arena, UnaryOp::Minus,
                         Expression::constant(7)))),
             Expression::constant(1));
 
-    EXPECT_EQ(to_string(value), to_string(expected));
+    EXPECT_EQ(to_string(value, symbols), to_string(expected, symbols));
     EXPECT_EQ(value, expected);
 }
 
 TEST(AstParserTests, VariableDeclaration) {
-    expressionRef.assign(expression);
+    SymbolTable symbols;
+    Arena arena;
 
-    const auto result = variableDeclaration.parse("let a = 1 + 2;");
+    const auto result = parse(variableDeclaration, "let a = 1 + 2;", symbols, arena);
     ASSERT_TRUE(result);
 
     const Statement& stmt = result.value();
     const auto& varDecl = std::get<VariableDeclarationStatement>(stmt.value);
     const Expression& initializer = varDecl.initializer;
-    EXPECT_EQ(varDecl.name, "a"sv);
+    EXPECT_EQ(symbols.name(varDecl.name), "a"sv);
     const Expression expected =
-        Expression::binary(BinaryOp::Add,
+        Expression::binary(arena, BinaryOp::Add,
             Expression::constant(1),
             Expression::constant(2));
 
@@ -225,43 +251,45 @@ TEST(AstParserTests, VariableDeclaration) {
 }
 
 TEST(AstParserTests, VariableAssignment) {
-    expressionRef.assign(expression);
+    SymbolTable symbols;
+    Arena arena;
 
-    const auto result = variableAssignment.parse("a = a + 2;");
+    const auto result = parse(variableAssignment, "a = a + 2;", symbols, arena);
     ASSERT_TRUE(result);
 
     const Statement& stmt = result.value();
     const auto& varAssign = std::get<VariableAssignmentStatement>(stmt.value);
     const Expression& expr = varAssign.expression;
-    EXPECT_EQ(varAssign.name, "a"sv);
+    EXPECT_EQ(symbols.name(varAssign.name), "a"sv);
     const Expression expected =
-        Expression::binary(BinaryOp::Add,
-            Expression::variable("a"),
+        Expression::binary(arena, BinaryOp::Add,
+            Expression::variable(symbols.intern("a")),
             Expression::constant(2));
 
     EXPECT_EQ(expr, expected);
 }
 
 TEST(AstParserTests, ReturnStatement) {
-    expressionRef.assign(expression);
+    SymbolTable symbols;
+    Arena arena;
 
-    const auto result = returnStatement.parse("return (x / 2);");
+    const auto result = parse(returnStatement, "return (x / 2);", symbols, arena);
     ASSERT_TRUE(result);
 
     const Statement& stmt = result.value();
     const auto& returnSt = std::get<ReturnStatement>(stmt.value);
     const Expression& expr = returnSt.expression;
     const Expression expected =
-        Expression::binary(BinaryOp::Divide,
-            Expression::variable("x"),
+        Expression::binary(arena, BinaryOp::Divide,
+            Expression::variable(symbols.intern("x")),
             Expression::constant(2));
 
     EXPECT_EQ(expr, expected);
 }
 
 TEST(AstParserTests, WhileStatement) {
-    expressionRef.assign(expression);
-    statementRef.assign(statement);
+    SymbolTable symbols;
+    Arena arena;
 
     constexpr std::string_view text = R"aa(
         while i < 10 {
@@ -270,15 +298,15 @@ TEST(AstParserTests, WhileStatement) {
         }
     )aa";
 
-    const auto result = whileStatement.wrap(ws_many).parse(text);
+    const auto result = parse(whileStatement.wrap(ws_many), text, symbols, arena);
     ASSERT_TRUE(result);
 
     const Statement& stmt = result.value();
     const auto& whileSt = std::get<WhileStatement>(stmt.value);
     const Expression& expr = whileSt.condition;
     const Expression expected =
-        Expression::binary(BinaryOp::LessThan,
-            Expression::variable("i"),
+        Expression::binary(arena, BinaryOp::LessThan,
+            Expression::variable(symbols.intern("i")),
             Expression::constant(10));
 
     EXPECT_EQ(expr, expected);
@@ -288,26 +316,26 @@ TEST(AstParserTests, WhileStatement) {
     const auto& first = std::get<VariableAssignmentStatement>(body[0].value);
     const auto& second = std::get<VariableAssignmentStatement>(body[1].value);
 
-    EXPECT_EQ(first.name, "a"sv);
+    EXPECT_EQ(symbols.name(first.name), "a"sv);
     const Expression firstExpr =
-        Expression::binary(BinaryOp::Divide,
-            Expression::variable("a"),
+        Expression::binary(arena, BinaryOp::Divide,
+            Expression::variable(symbols.intern("a")),
             Expression::constant(2));
 
     EXPECT_EQ(first.expression, firstExpr);
 
-    EXPECT_EQ(second.name, "i"sv);
+    EXPECT_EQ(symbols.name(second.name), "i"sv);
     const Expression secondExpr =
-        Expression::binary(BinaryOp::Add,
-            Expression::variable("i"),
+        Expression::binary(arena, BinaryOp::Add,
+            Expression::variable(symbols.intern("i")),
             Expression::constant(1));
 
     EXPECT_EQ(second.expression, secondExpr);
 }
 
 TEST(AstParserTests, Function1) {
-    expressionRef.assign(expression);
-    statementRef.assign(statement);
+    SymbolTable symbols;
+    Arena arena;
 
     constexpr std::string_view text = R"aa(
         fn add(a, b) {
@@ -315,13 +343,13 @@ TEST(AstParserTests, Function1) {
         }
     )aa";
 
-    const auto result = function.wrap(ws_many).parse(text);
+    const auto result = parse(function.wrap(ws_many), text, symbols, arena);
     ASSERT_TRUE(result);
 }
 
 TEST(AstParserTests, Function2) {
-    expressionRef.assign(expression);
-    statementRef.assign(statement);
+    SymbolTable symbols;
+    Arena arena;
 
     constexpr std::string_view text = R"aa(
         fn add_numbers(a, b) {
@@ -332,19 +360,19 @@ TEST(AstParserTests, Function2) {
         }
     )aa";
 
-    const auto result = function.wrap(ws_many).parse(text);
+    const auto result = parse(function.wrap(ws_many), text, symbols, arena);
     ASSERT_TRUE(result);
 
     const auto& func = result.value();
-    EXPECT_EQ(func.name, "add_numbers"sv);
+    EXPECT_EQ(symbols.name(func.name), "add_numbers"sv);
     EXPECT_EQ(func.arguments.size(), 2);
     EXPECT_EQ(func.statements.size(), 1);
     EXPECT_TRUE(func.lastExpression.has_value());
 }
 
 TEST(AstParserTests, Unit) {
-    expressionRef.assign(expression);
-    statementRef.assign(statement);
+    SymbolTable symbols;
+    Arena arena;
 
     constexpr std::string_view text = R"aa(
         fn add_numbers(a, b) {
@@ -363,6 +391,85 @@ TEST(AstParserTests, Unit) {
         }
     )aa";
 
-    const auto result = unit.parse(text);
+    auto result = parse(unit, text, symbols, arena);
     ASSERT_TRUE(result);
+
+    // nodes stay valid when the storage is moved into the unit
+    Unit& value = result.value();
+    value.symbols = std::move(symbols);
+    value.arena = std::move(arena);
+    ASSERT_FALSE(value.functions.empty());
+    EXPECT_EQ(value.symbols.name(value.functions[0].name), "add_numbers"sv);
+    ASSERT_TRUE(value.functions[0].lastExpression.has_value());
+    EXPECT_EQ(to_string(*value.functions[0].lastExpression, value.symbols), "(a + b)"sv);
+}
+
+TEST(AstParserTests, ConcurrentGrammars) {
+    constexpr std::string_view text = R"aa(
+        fn add_numbers(a, b) {
+            while a < 10 {
+                a = a + 1;
+            }
+            a + b * (a - 2)
+        }
+
+        fn main(x) {
+            let y = add_numbers(x, 5);
+        }
+    )aa";
+
+    // the grammar of this file and the grammar of the compiler are parsed concurrently, without any setup
+    constexpr size_t thread_count = 16;
+    constexpr size_t iterations = 200;
+    std::atomic<size_t> failures {};
+    {
+        std::vector<std::jthread> threads;
+        for (size_t i = 0; i < thread_count; ++i) {
+            threads.emplace_back([&, i] {
+                for (size_t j = 0; j < iterations; ++j) {
+                    SymbolTable symbols;
+                    Arena arena;
+                    auto result = i % 2 == 0 ? parse(unit, text, symbols, arena) : parse_unit(text);
+                    if (!result) {
+                        failures.fetch_add(1, std::memory_order_relaxed);
+                        continue;
+                    }
+
+                    const SymbolTable& names = i % 2 == 0 ? symbols : result->symbols;
+                    if (result->functions.size() != 2 || !result->functions[0].lastExpression ||
+                        to_string(*result->functions[0].lastExpression, names) != "(a + (b * (a - 2)))"sv) {
+                        failures.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+    }
+
+    EXPECT_EQ(failures.load(), 0U);
+}
+
+TEST(AstParserTests, ChunkedUnit) {
+    std::string text;
+    for (size_t i = 0; i < 50; ++i) {
+        text += "fn f" + std::to_string(i) + "(a, b) {\n    while a < 10 {\n        a = a + 1;\n    }\n    a + b * (a - 2)\n}\n\n";
+    }
+
+    ParserContext<char> ctx {InputReader<char> {[&text, offset = size_t {0}](const std::span<char> buffer) mutable {
+        const size_t count = std::min(buffer.size(), text.size() - offset);
+        std::ranges::copy(std::string_view {text}.substr(offset, count), buffer.begin());
+        offset += count;
+        return count;
+    }}, 16};
+
+    const auto chunked = parse_unit(ctx);
+    const auto contiguous = parse_unit(text);
+    ASSERT_TRUE(chunked);
+    ASSERT_TRUE(contiguous);
+    ASSERT_EQ(chunked->functions.size(), contiguous->functions.size());
+    for (size_t i = 0; i < chunked->functions.size(); ++i) {
+        EXPECT_EQ(chunked->symbols.name(chunked->functions[i].name), contiguous->symbols.name(contiguous->functions[i].name));
+        ASSERT_TRUE(chunked->functions[i].lastExpression.has_value());
+        EXPECT_EQ(to_string(*chunked->functions[i].lastExpression, chunked->symbols),
+            to_string(*contiguous->functions[i].lastExpression, contiguous->symbols));
+    }
 }
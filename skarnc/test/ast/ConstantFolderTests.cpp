@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "TestUnits.h"
+#include "ast/ConstantFolder.h"
+
+using namespace std::string_view_literals;
+using namespace skarn::ast;
+using namespace skarn::test;
+
+namespace {
+Unit fold(const std::string_view source, const size_t eliminated) {
+    Unit unit = infer(std::format("fn f(x) {{ {} }} fn g() {{ 0 }}", source));
+    EXPECT_EQ(fold_constants(unit), eliminated) << source;
+    return unit;
+}
+
+/// Folds the result of a function with the argument x, the expected result is parsed and its chains are flattened.
+void expect_folded(const std::string_view source, const std::string_view expected, const size_t eliminated) {
+    const Unit unit = fold(source, eliminated);
+    Unit expected_unit = infer(std::format("fn f(x) {{ {} }} fn g() {{ 0 }}", expected));
+    fold_constants(expected_unit);
+    EXPECT_EQ(*unit.functions[0].lastExpression, *expected_unit.functions[0].lastExpression) << source;
+}
+
+void expect_folded(const std::string_view source, const int expected, const TypeKind type, const size_t eliminated) {
+    const Unit unit = fold(source, eliminated);
+    EXPECT_EQ(*unit.functions[0].lastExpression, Expression::constant(expected)) << source;
+    EXPECT_EQ(unit.functions[0].lastExpression->type.kind, type) << source;
+}
+
+const BinaryExpression& binary(const Expression& expression) {
+    return std::get<BinaryExpression>(expression.value);
+}
+} // namespace
+
+TEST(ConstantFolderTests, Constants)
+{
+    expect_folded("1 + 2 * 3", 7, TypeKind::Int, 4);
+    expect_folded("(10 - 4) / 2 - -3", 6, TypeKind::Int, 7);
+    expect_folded("-(2 * 3)", -6, TypeKind::Int, 3);
+    expect_folded("x - x + 1 < 2", "x - x + 1 < 2", 0);
+    expect_folded("1 / 0", "1 / 0", 0);
+    expect_folded("2147483647 + 1", "2147483647 + 1", 0);
+
+    const Unit unit = fold("-(-2147483647 - 1)", 3);
+    const auto& negation = std::get<UnaryExpression>(unit.functions[0].lastExpression->value);
+    EXPECT_EQ(*negation.arg, Expression::constant(std::numeric_limits<int>::min()));
+}
+
+TEST(ConstantFolderTests, Comparisons)
+{
+    expect_folded("1 < 2", 1, TypeKind::Bool, 2);
+    expect_folded("2 * 3 == 3 + 3", 1, TypeKind::Bool, 6);
+    expect_folded("(1 == 2) != (2 >= 3)", 0, TypeKind::Bool, 6);
+
+    const Unit unit = fold("(x < 1) == (3 != 3)", 2);
+    const BinaryExpression& equal = binary(*unit.functions[0].lastExpression);
+    ASSERT_EQ(equal.args.size(), 2U);
+    EXPECT_EQ(equal.args[1], Expression::constant(0));
+    EXPECT_EQ(equal.args[1].type.kind, TypeKind::Bool);
+
+    auto untyped = parse_unit("fn main() { 1 < 2 }");
+    ASSERT_TRUE(untyped);
+    EXPECT_EQ(fold_constants(*untyped), 0U);
+}
+
+TEST(ConstantFolderTests, Identities)
+{
+    expect_folded("x + 0", "x", 2);
+    expect_folded("0 + x", "x", 2);
+    expect_folded("x - 0", "x", 2);
+    expect_folded("x * 1", "x", 2);
+    expect_folded("x / 1", "x", 2);
+    expect_folded("-(-x)", "x", 2);
+    expect_folded("x * 0 + 5", 5, TypeKind::Int, 4);
+    expect_folded("g() * 0", "g() * 0", 0);
+    expect_folded("(x / 2) * 0", "(x / 2) * 0", 0);
+    expect_folded("0 / x", "0 / x", 0);
+}
+
+TEST(ConstantFolderTests, Chains)
+{
+    expect_folded("x + 1 + x + 2", "x + 3 + x", 3);
+    expect_folded("2 * (x * (3 * x))", "6 * x * x", 3);
+    expect_folded("x - 1 - g() - 2", "x - 3 - g()", 3);
+    expect_folded("10 - x - 4", "6 - x", 2);
+    expect_folded("x - (g() - 1)", "x - (g() - 1)", 0);
+    expect_folded("100 / 5 / x / 1", "20 / x", 4);
+
+    const Unit unit = fold("x + x * 2 + x + g()", 2);
+    const BinaryExpression& sum = binary(*unit.functions[0].lastExpression);
+    ASSERT_EQ(sum.args.size(), 4U);
+    EXPECT_EQ(sum.op, BinaryOp::Add);
+    EXPECT_EQ(binary(sum.args[1]).op, BinaryOp::Multiply);
+    EXPECT_TRUE(std::holds_alternative<FunctionCallExpression>(sum.args[3].value));
+}
+
+TEST(ConstantFolderTests, Statements)
+{
+    Unit unit = infer(R"(
+        fn main() {
+            let a = 2 * 3;
+            while a < 3 + 4 {
+                a = a + 1 + 1;
+                return a * 1;
+            }
+
+            println("{}", 1 + 1);
+        }
+    )");
+
+    EXPECT_EQ(fold_constants(unit), 2U + 2U + 2U + 2U + 2U);
+
+    const Function& main = unit.functions[0];
+    EXPECT_EQ(std::get<VariableDeclarationStatement>(main.statements[0].value).initializer, Expression::constant(6));
+    const auto& loop = std::get<WhileStatement>(main.statements[1].value);
+    EXPECT_EQ(binary(loop.condition).args[1], Expression::constant(7));
+    EXPECT_EQ(binary(std::get<VariableAssignmentStatement>(loop.statements[0].value).expression).args[1], Expression::constant(2));
+    EXPECT_TRUE(std::holds_alternative<VariableExpression>(std::get<ReturnStatement>(loop.statements[1].value).expression.value));
+
+    const auto& println = std::get<FunctionCallExpression>(std::get<ExpressionStatement>(main.statements[2].value).expression.value);
+    EXPECT_EQ(println.args[1], Expression::constant(2));
+    EXPECT_EQ(println.args[1].type.kind, TypeKind::Int);
+}
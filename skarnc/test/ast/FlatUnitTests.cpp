@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "ast/FlatUnit.h"
+
+using namespace std::string_view_literals;
+using namespace skarn::ast;
+using skarn::Arena;
+
+TEST(FlatUnitTests, Expression)
+{
+    SymbolTable symbols;
+    Arena arena;
+    const Expression expression =
+        Expression::binary(arena, BinaryOp::Add,
+            Expression::variable(symbols.intern("a")),
+            Expression::binary(arena, BinaryOp::Multiply,
+                Expression::constant(2),
+                Expression::unary(arena, UnaryOp::Minus,
+                    Expression::function(arena, symbols.intern("f"),
+                        Expression::variable(symbols.intern("b")),
+                        Expression::constant(3)))));
+
+    FlatUnit unit;
+    const NodeIndex root = unit.add(expression);
+    EXPECT_EQ(unit.size(), 8U);
+    EXPECT_EQ(root, 7U);
+    EXPECT_EQ(unit.subtree_begin(root), 0U);
+    EXPECT_EQ(to_string(unit, root, symbols), to_string(expression, symbols));
+
+    ASSERT_EQ(unit.kind(root), NodeKind::Binary);
+    EXPECT_EQ(unit.binary_op(root), BinaryOp::Add);
+    const auto children = unit.children(root);
+    ASSERT_EQ(children.size(), 2U);
+    EXPECT_EQ(unit.kind(children[0]), NodeKind::Variable);
+    EXPECT_EQ(symbols.name(unit.name(children[0])), "a"sv);
+    EXPECT_EQ(unit.kind(children[1]), NodeKind::Binary);
+    EXPECT_EQ(unit.binary_op(children[1]), BinaryOp::Multiply);
+}
+
+TEST(FlatUnitTests, PostOrder)
+{
+    SymbolTable symbols;
+    Arena arena;
+    const Expression expression =
+        Expression::binary(arena, BinaryOp::Subtract,
+            Expression::constant(10),
+            Expression::binary(arena, BinaryOp::Add,
+                Expression::constant(1),
+                Expression::constant(2),
+                Expression::constant(3)));
+
+    FlatUnit unit;
+    const NodeIndex root = unit.add(expression);
+
+    std::vector<NodeIndex> order;
+    unit.visit_post_order(root, [&](const NodeIndex node) {
+        for (const NodeIndex child : unit.children(node)) {
+            EXPECT_LT(child, node);
+        }
+
+        order.push_back(node);
+    });
+
+    EXPECT_EQ(order.size(), unit.size());
+
+    const int value = unit.fold<int>(root, [&](const NodeIndex node, const std::span<int> args) {
+        switch (unit.kind(node)) {
+            case NodeKind::Constant:
+                return unit.constant(node);
+            case NodeKind::Binary:
+                if (unit.binary_op(node) == BinaryOp::Add) {
+                    return args[0] + args[1] + args[2];
+                }
+
+                return args[0] - args[1];
+            default:
+                return 0;
+        }
+    });
+
+    EXPECT_EQ(value, 4);
+
+    const NodeIndex sum = unit.children(root)[1];
+    EXPECT_EQ(unit.subtree_begin(sum), 1U);
+    EXPECT_EQ(unit.fold<int>(sum, [&](const NodeIndex node, const std::span<int> args) {
+        return unit.kind(node) == NodeKind::Constant ? unit.constant(node) : args[0] + args[1] + args[2];
+    }), 6);
+}
+
+TEST(FlatUnitTests, Unit)
+{
+    Unit unit;
+    Arena& arena = unit.arena;
+    SymbolTable& symbols = unit.symbols;
+
+    const Symbol i = symbols.intern("i");
+    Function function {
+        .name = symbols.intern("count"),
+        .arguments = {FunctionArgument {.name = symbols.intern("n")}},
+        .statements = {},
+        .lastExpression = Expression::variable(i),
+    };
+
+    function.statements.emplace_back(Statement::variableDeclaration(i, Expression::constant(0)));
+    function.statements.emplace_back(Statement::whileStatement(
+        Expression::binary(arena, BinaryOp::LessThan, Expression::variable(i), Expression::variable(symbols.intern("n"))),
+        {Statement::variableAssignment(i, Expression::binary(arena, BinaryOp::Add, Expression::variable(i), Expression::constant(1)))}));
+
+    unit.functions.push_back(std::move(function));
+
+    const FlatUnit flat = flatten(unit);
+    ASSERT_EQ(flat.functions().size(), 1U);
+    const NodeIndex root = flat.functions()[0];
+    EXPECT_EQ(root + 1, flat.size());
+    EXPECT_EQ(flat.kind(root), NodeKind::Function);
+    EXPECT_EQ(symbols.name(flat.name(root)), "count"sv);
+
+    const auto children = flat.children(root);
+    ASSERT_EQ(children.size(), 4U);
+    EXPECT_EQ(flat.kind(children[0]), NodeKind::Argument);
+    EXPECT_EQ(flat.kind(children[1]), NodeKind::VariableDeclaration);
+    EXPECT_EQ(flat.kind(children[2]), NodeKind::While);
+    EXPECT_EQ(flat.kind(children[3]), NodeKind::LastExpression);
+
+    const auto loop = flat.children(children[2]);
+    ASSERT_EQ(loop.size(), 2U);
+    EXPECT_EQ(to_string(flat, loop[0], symbols), "(i < n)"sv);
+    EXPECT_EQ(flat.kind(loop[1]), NodeKind::VariableAssignment);
+    EXPECT_EQ(to_string(flat, flat.children(loop[1])[0], symbols), "(i + 1)"sv);
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "ast/Analysis.h"
+#include "ast/ParallelParser.h"
+#include "bytecode/Compiler.h"
+#include "bytecode/Disassembler.h"
+#include <format>
+#include <string>
+
+using namespace std::string_view_literals;
+using namespace skarn;
+using namespace skarn::ast;
+
+namespace {
+std::string synthetic_source(const size_t count) {
+    std::string source;
+    for (size_t i = 0; i < count; ++i) {
+        source += std::format(R"(
+            fn f{0}(n) {{
+                let a = n * {0};
+                while a > 10 {{
+                    a = a / 2;
+                }}
+
+                println("f{0}: {{}}", a);
+                {1}
+            }}
+        )", i, i == 0 ? std::string {"a"} : std::format("a + f{}(n - 1)", i - 1));
+    }
+
+    return source;
+}
+
+std::string disassemble(Unit& unit) {
+    ThreadPool pool {1};
+    std::ignore = analyze(unit, pool);
+    return bytecode::disassemble(bytecode::compile(unit));
+}
+} // namespace
+
+TEST(ParallelParserTests, SplitFunctions)
+{
+    const auto slices = split_functions("fn a() { 1 }\n  fn b(x) { while x { x = x - 1; } println(\"}\"); }\n\n");
+    ASSERT_TRUE(slices);
+    ASSERT_EQ(slices->size(), 2U);
+    EXPECT_EQ((*slices)[0], "fn a() { 1 }"sv);
+    EXPECT_EQ((*slices)[1], "\n  fn b(x) { while x { x = x - 1; } println(\"}\"); }"sv);
+
+    EXPECT_TRUE(split_functions(" \n ").value().empty());
+    EXPECT_FALSE(split_functions("fn a() { } }"));
+    EXPECT_FALSE(split_functions("fn a() { "));
+    EXPECT_FALSE(split_functions("fn a() { } b"));
+}
+
+TEST(ParallelParserTests, SameAsSequential)
+{
+    const std::string source = synthetic_source(300);
+    ThreadPool pool {4};
+    auto parallel = parse_unit(source, pool);
+    auto sequential = parse_unit(source);
+    ASSERT_TRUE(parallel);
+    ASSERT_TRUE(sequential);
+
+    ASSERT_EQ(parallel->functions.size(), 300U);
+    EXPECT_EQ(parallel->symbols.name(parallel->functions[299].name), "f299"sv);
+    EXPECT_EQ(to_string(*parallel->functions[7].lastExpression, parallel->symbols),
+        to_string(*sequential->functions[7].lastExpression, sequential->symbols));
+    EXPECT_EQ(disassemble(*parallel), disassemble(*sequential));
+}
+
+TEST(ParallelParserTests, Errors)
+{
+    std::string source = synthetic_source(300);
+    source.insert(source.find("fn f250"), "fn broken( { }\n");
+    source.insert(source.find("fn f150"), "fn g() { let x = ; }\n");
+
+    ThreadPool pool {4};
+    const auto parallel = parse_unit(source, pool);
+    const auto sequential = parse_unit(source);
+    ASSERT_FALSE(parallel);
+    ASSERT_FALSE(sequential);
+    ASSERT_EQ(parallel.error().size(), sequential.error().size());
+    EXPECT_EQ(parallel.error()[0].expected, sequential.error()[0].expected);
+    EXPECT_EQ(parallel.error()[0].offset, sequential.error()[0].offset);
+    EXPECT_EQ(parallel.error()[0].line, sequential.error()[0].line);
+    EXPECT_EQ(parallel.error()[0].column, sequential.error()[0].column);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "TestUnits.h"
+#include "ast/SlotResolver.h"
+
+using namespace std::string_view_literals;
+using namespace skarn::ast;
+using namespace skarn::test;
+
+namespace {
+uint32_t slot(const Expression& expression) {
+    return std::get<VariableExpression>(expression.value).slot;
+}
+
+template <class T>
+const T& statement(const std::vector<Statement>& statements, const size_t index) {
+    return std::get<T>(statements[index].value);
+}
+} // namespace
+
+TEST(SlotResolverTests, Slots)
+{
+    Unit unit = parse_unresolved(R"(
+        fn fib(n) {
+            let a = 0;
+            let b = 1;
+            while 0 < n {
+                let tmp = a;
+                a = b;
+                b = tmp + a;
+                n = n - 1;
+            }
+
+            a
+        }
+
+        fn main() {
+            println("{}", fib(5));
+        }
+    )");
+
+    EXPECT_TRUE(resolve_slots(unit).empty());
+
+    const Function& fib = unit.functions[0];
+    EXPECT_EQ(fib.slotCount, 4U);
+    EXPECT_EQ(statement<VariableDeclarationStatement>(fib.statements, 1).slot, 2U);
+
+    const auto& loop = statement<WhileStatement>(fib.statements, 2);
+    EXPECT_EQ(slot(std::get<BinaryExpression>(loop.condition.value).args[1]), 0U);
+    EXPECT_EQ(statement<VariableDeclarationStatement>(loop.statements, 0).slot, 3U);
+    EXPECT_EQ(slot(statement<VariableDeclarationStatement>(loop.statements, 0).initializer), 1U);
+    EXPECT_EQ(statement<VariableAssignmentStatement>(loop.statements, 2).slot, 2U);
+    EXPECT_EQ(slot(*fib.lastExpression), 1U);
+
+    const auto& println = std::get<FunctionCallExpression>(statement<ExpressionStatement>(unit.functions[1].statements, 0).expression.value);
+    EXPECT_EQ(println.callee, unresolved_index);
+    EXPECT_EQ(std::get<FunctionCallExpression>(println.args[1].value).callee, 0U);
+    EXPECT_EQ(unit.functions[1].slotCount, 0U);
+}
+
+TEST(SlotResolverTests, Blocks)
+{
+    Unit unit = parse_unresolved(R"(
+        fn f(x) {
+            while x {
+                let t = x;
+                x = t - 1;
+            }
+
+            let t = 2;
+            while x {
+                let u = t;
+            }
+
+            t
+        }
+    )");
+
+    EXPECT_TRUE(resolve_slots(unit).empty());
+
+    const Function& f = unit.functions[0];
+    EXPECT_EQ(f.slotCount, 4U);
+    EXPECT_EQ(statement<VariableDeclarationStatement>(f.statements, 1).slot, 2U);
+    EXPECT_EQ(slot(statement<VariableDeclarationStatement>(statement<WhileStatement>(f.statements, 2).statements, 0).initializer), 2U);
+    EXPECT_EQ(slot(*f.lastExpression), 2U);
+
+    Unit outside = parse_unresolved("fn f(x) { while x { let t = 1; } t }");
+    EXPECT_THROW(resolve_slots(outside), std::runtime_error);
+}
+
+TEST(SlotResolverTests, Shadowing)
+{
+    Unit unit = parse_unresolved(R"(
+        fn f(x) {
+            let x = x + 1;
+            while x {
+                let x = 0;
+                x = 1;
+            }
+
+            x
+        }
+    )");
+
+    const std::vector<std::string> warnings = resolve_slots(unit);
+    ASSERT_EQ(warnings.size(), 2U);
+    EXPECT_EQ(warnings[0], "shadowed variable 'x' in function 'f'");
+
+    const Function& f = unit.functions[0];
+    const auto& declaration = statement<VariableDeclarationStatement>(f.statements, 0);
+    EXPECT_EQ(declaration.slot, 1U);
+    EXPECT_EQ(slot(std::get<BinaryExpression>(declaration.initializer.value).args[0]), 0U);
+    EXPECT_EQ(statement<VariableAssignmentStatement>(statement<WhileStatement>(f.statements, 1).statements, 1).slot, 2U);
+    EXPECT_EQ(slot(*f.lastExpression), 1U);
+}
+
+TEST(SlotResolverTests, Errors)
+{
+    Unit undefined = parse_unresolved("fn main() { x }");
+    EXPECT_THROW(resolve_slots(undefined), std::runtime_error);
+
+    Unit assignment = parse_unresolved("fn main() { x = 1; }");
+    EXPECT_THROW(resolve_slots(assignment), std::runtime_error);
+
+    Unit initializer = parse_unresolved("fn main() { let x = x; }");
+    EXPECT_THROW(resolve_slots(initializer), std::runtime_error);
+
+    Unit argument = parse_unresolved("fn f(a, a) { a }");
+    EXPECT_THROW(resolve_slots(argument), std::runtime_error);
+
+    Unit function = parse_unresolved("fn f() { 0 } fn f() { 1 }");
+    EXPECT_THROW(resolve_slots(function), std::runtime_error);
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "ast/Symbol.h"
+#include <format>
+#include <string>
+
+using namespace std::string_view_literals;
+using namespace skarn::ast;
+
+TEST(SymbolTableTests, Intern)
+{
+    SymbolTable symbols;
+    const Symbol a = symbols.intern("a"sv);
+    const Symbol b = symbols.intern("b"sv);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(symbols.intern("a"sv), a);
+    EXPECT_EQ(symbols.name(a), "a"sv);
+    EXPECT_EQ(symbols.name(b), "b"sv);
+    EXPECT_EQ(symbols.size(), 3U);
+}
+
+TEST(SymbolTableTests, EmptyName)
+{
+    SymbolTable symbols;
+    EXPECT_EQ(symbols.intern({}), Symbol {});
+    EXPECT_EQ(symbols.name(Symbol {}), ""sv);
+}
+
+TEST(SymbolTableTests, Find)
+{
+    SymbolTable symbols;
+    EXPECT_EQ(symbols.find("a"sv), std::nullopt);
+    const Symbol a = symbols.intern("a"sv);
+    EXPECT_EQ(symbols.find("a"sv), a);
+}
+
+TEST(SymbolTableTests, Names)
+{
+    SymbolTable symbols;
+    std::string source;
+    std::vector<Symbol> ids;
+    for (int i = 0; i < 10000; ++i) {
+        source = std::format("name_{}", i);
+        ids.push_back(symbols.intern(source));
+    }
+
+    EXPECT_EQ(symbols.size(), 10001U);
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_EQ(symbols.name(ids[i]), std::format("name_{}", i));
+        EXPECT_EQ(symbols.intern(std::format("name_{}", i)), ids[i]);
+    }
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "TestUnits.h"
+#include "ast/TypeInference.h"
+
+using namespace std::string_view_literals;
+using namespace skarn::ast;
+using namespace skarn::test;
+
+TEST(TypeInferenceTests, Functions)
+{
+    const Unit unit = infer(R"(
+        fn fib(n) {
+            while less(n, 2) {
+                return n;
+            }
+
+            fib(n - 1) + fib(n - 2)
+        }
+
+        fn less(a, b) {
+            let same = a == b;
+            return a < b;
+        }
+
+        fn unused(x) {
+            println("{}", less(1, 2));
+        }
+    )");
+
+    const Function& fib = unit.functions[0];
+    EXPECT_EQ(fib.returnType.kind, TypeKind::Int);
+    EXPECT_EQ(fib.arguments[0].type.kind, TypeKind::Int);
+    EXPECT_EQ(std::get<WhileStatement>(fib.statements[0].value).condition.type.kind, TypeKind::Bool);
+    EXPECT_EQ(fib.lastExpression->type.kind, TypeKind::Int);
+
+    const Function& less = unit.functions[1];
+    EXPECT_EQ(less.returnType.kind, TypeKind::Bool);
+    EXPECT_EQ(less.arguments[1].type.kind, TypeKind::Int);
+    EXPECT_EQ(std::get<VariableDeclarationStatement>(less.statements[0].value).type.kind, TypeKind::Bool);
+
+    const Function& unused = unit.functions[2];
+    EXPECT_EQ(unused.returnType.kind, TypeKind::Int);
+    EXPECT_EQ(unused.arguments[0].type.kind, TypeKind::Int);
+
+    const auto& println = std::get<FunctionCallExpression>(std::get<ExpressionStatement>(unused.statements[0].value).expression.value);
+    EXPECT_EQ(println.args[0].type.kind, TypeKind::String);
+    EXPECT_EQ(println.args[1].type.kind, TypeKind::Bool);
+}
+
+TEST(TypeInferenceTests, Variables)
+{
+    const Unit unit = infer(R"(
+        fn main() {
+            let flag = 1 < 2;
+            flag = flag != (2 == 3);
+            let count = -1;
+            count = count * 2;
+            flag == flag
+        }
+    )");
+
+    const Function& main = unit.functions[0];
+    EXPECT_EQ(std::get<VariableDeclarationStatement>(main.statements[0].value).type.kind, TypeKind::Bool);
+    EXPECT_EQ(std::get<VariableAssignmentStatement>(main.statements[1].value).type.kind, TypeKind::Bool);
+    EXPECT_EQ(std::get<VariableDeclarationStatement>(main.statements[2].value).type.kind, TypeKind::Int);
+    EXPECT_EQ(std::get<VariableAssignmentStatement>(main.statements[3].value).type.kind, TypeKind::Int);
+    EXPECT_EQ(main.returnType.kind, TypeKind::Bool);
+}
+
+TEST(TypeInferenceTests, Errors)
+{
+    Unit arithmetic = parse("fn main() { 1 + (2 < 3) }");
+    EXPECT_THROW(infer_types(arithmetic), std::runtime_error);
+
+    Unit variable = parse("fn main() { let a = 1; a = 1 == 1; }");
+    EXPECT_THROW(infer_types(variable), std::runtime_error);
+
+    Unit argument = parse("fn f(a) { a } fn main() { f(1) + f(1 < 2) }");
+    EXPECT_THROW(infer_types(argument), std::runtime_error);
+
+    Unit result = parse("fn f(a) { while a { return a < 1; } 0 }");
+    EXPECT_THROW(infer_types(result), std::runtime_error);
+
+    Unit fallthrough = parse("fn f(a) { while a { return a < 1; } }");
+    EXPECT_THROW(infer_types(fallthrough), std::runtime_error);
+
+    Unit string = parse("fn main() { \"text\" }");
+    EXPECT_THROW(infer_types(string), std::runtime_error);
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include "TestUnits.h"
+#include "bytecode/Compiler.h"
+#include "bytecode/Disassembler.h"
+#include "bytecode/Vm.h"
+#include "interpreter/Interpreter.h"
+#include <sstream>
+
+using namespace std::string_view_literals;
+using namespace skarn;
+using namespace skarn::bytecode;
+using namespace skarn::test;
+
+TEST(VmTests, Example)
+{
+    const ast::Unit unit = parse(fibSource);
+    const Program program = compile(unit);
+    std::ostringstream out;
+    Vm vm {program, out};
+    EXPECT_EQ(vm.run(), 0);
+    EXPECT_EQ(out.str(), "fib(5)=5\n");
+
+    const Value args[] {40};
+    EXPECT_EQ(vm.call("fib", args), 102334155);
+}
+
+TEST(VmTests, Recursion)
+{
+    const ast::Unit unit = parse(recursiveFibSource);
+
+    const Program program = compile(unit);
+    std::ostringstream out;
+    Vm vm {program, out};
+    const Value args[] {20};
+    EXPECT_EQ(vm.call("fib", args), 6765);
+}
+
+TEST(VmTests, SameAsInterpreter)
+{
+    const ast::Unit unit = parse(mixSource);
+
+    std::ostringstream expectedOut;
+    const interpreter::Value expected = interpreter::Interpreter {unit, expectedOut}.run();
+
+    const Program program = compile(unit);
+    std::ostringstream out;
+    EXPECT_EQ(Vm(program, out).run(), expected);
+    EXPECT_EQ(out.str(), expectedOut.str());
+}
+
+TEST(VmTests, PrintlnEvaluatesEveryArgument)
+{
+    const ast::Unit unit = parse(printlnArgumentsSource);
+
+    std::ostringstream expectedOut;
+    std::ignore = interpreter::Interpreter {unit, expectedOut}.run();
+    EXPECT_EQ(expectedOut.str(), "side effect 1\nside effect 2\n1\n"sv);
+
+    const Program program = compile(unit);
+    std::ostringstream out;
+    std::ignore = Vm(program, out).run();
+    EXPECT_EQ(out.str(), expectedOut.str());
+}
+
+TEST(VmTests, OverflowSameAsInterpreter)
+{
+    const ast::Unit unit = parse(overflowSource);
+
+    std::ostringstream expectedOut;
+    const interpreter::Value expected = interpreter::Interpreter {unit, expectedOut}.run();
+
+    const Program program = compile(unit);
+    std::ostringstream out;
+    EXPECT_EQ(Vm(program, out).run(), expected);
+    EXPECT_EQ(out.str(), expectedOut.str());
+}
+
+TEST(VmTests, Errors)
+{
+    std::ostringstream out;
+
+    const Program division = compile(parse("fn main() { 1 / (1 - 1) }"));
+    EXPECT_THROW(std::ignore = Vm(division, out).run(), std::runtime_error);
+
+    EXPECT_THROW(std::ignore = compile(parse("fn main() { missing(1) }")), std::runtime_error);
+
+    const Program overflow = compile(parse("fn main() { main() }"));
+    Vm vm {overflow, out, 1000};
+    EXPECT_THROW(std::ignore = vm.run(), std::runtime_error);
+    EXPECT_THROW(std::ignore = vm.run(), std::runtime_error);
+    EXPECT_THROW(std::ignore = vm.call("other"), std::runtime_error);
+}
+
+TEST(VmTests, RecursionWithoutRegisters)
+{
+    const Program program = compile(parse("fn main() { main() }"));
+    EXPECT_EQ(disassemble(program),
+        "fn main: 0 arguments, 1 registers\n"
+        "   0: call r0, main, r1\n"
+        "   1: return r0\n");
+
+    std::ostringstream out;
+    Vm vm {program, out, 1000};
+    try {
+        std::ignore = vm.run();
+        ADD_FAILURE() << "expected an error";
+    }
+    catch (const std::runtime_error& e) {
+        EXPECT_EQ(e.what(), "Stack overflow"sv);
+    }
+}
+
+TEST(VmTests, SameCallDepthAsInterpreter)
+{
+    const ast::Unit unit = parse(countdownSource);
+
+    // 10 calls may be active, countdown(n) makes n + 1 calls
+    const CallLimits limits {.native_stack_size = 10 * CallLimits::native_frame_size};
+    const Program program = compile(unit);
+    std::ostringstream out;
+    interpreter::Interpreter reference {unit, out, interpreter::Interpreter::default_stack_size, limits};
+    Vm vm {program, out, Vm::default_register_count, limits};
+
+    const Value fits[] {9};
+    EXPECT_EQ(reference.call("countdown", fits), 0);
+    EXPECT_EQ(vm.call("countdown", fits), 0);
+
+    const Value overflows[] {10};
+    EXPECT_THROW(std::ignore = reference.call("countdown", overflows), std::runtime_error);
+    EXPECT_THROW(std::ignore = vm.call("countdown", overflows), std::runtime_error);
+}
+
+TEST(VmTests, Disassemble)
+{
+    const Program program = compile(parse(R"(
+        fn twice(n) {
+            while n < 0 {
+                return 0;
+            }
+
+            n * 2
+        }
+
+        fn main() {
+            println("{}", twice(-21));
+        }
+    )"));
+
+    EXPECT_EQ(disassemble(program),
+        "fn twice: 1 arguments, 3 registers\n"
+        "   0: load_int r2, 0\n"
+        "   1: less_than r1, r0, r2\n"
+        "   2: jump_if_false r1, @6\n"
+        "   3: load_int r1, 0\n"
+        "   4: return r1\n"
+        "   5: jump @0\n"
+        "   6: load_int r2, 2\n"
+        "   7: multiply r1, r0, r2\n"
+        "   8: return r1\n"
+        "fn main: 0 arguments, 3 registers\n"
+        "   0: load_int r2, 21\n"
+        "   1: negate r1, r2\n"
+        "   2: call r1, twice, r1\n"
+        "   3: println \"{}\", r1, 1\n"
+        "   4: load_int r0, 0\n"
+        "   5: load_int r0, 0\n"
+        "   6: return r0\n");
+}
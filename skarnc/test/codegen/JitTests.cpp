@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "TestUnits.h"
+#include "codegen/Jit.h"
+#include "interpreter/Interpreter.h"
+#include <sstream>
+
+using namespace std::string_view_literals;
+using namespace skarn;
+using namespace skarn::codegen;
+using namespace skarn::test;
+
+TEST(JitTests, Example)
+{
+    const ast::Unit unit = parse(fibSource);
+    std::ostringstream out;
+    Jit jit {unit, out};
+    EXPECT_EQ(jit.run(), 0);
+    EXPECT_EQ(out.str(), "fib(5)=5\n");
+
+    const Value args[] {40};
+    EXPECT_EQ(jit.call("fib", args), 102334155);
+}
+
+TEST(JitTests, Recursion)
+{
+    const ast::Unit unit = parse(recursiveFibSource);
+
+    std::ostringstream out;
+    Jit jit {unit, out, llvm::OptimizationLevel::O0};
+    const Value args[] {20};
+    EXPECT_EQ(jit.call("fib", args), 6765);
+}
+
+TEST(JitTests, SameAsInterpreter)
+{
+    const ast::Unit unit = parse(mixSource);
+
+    std::ostringstream expectedOut;
+    const interpreter::Value expected = interpreter::Interpreter {unit, expectedOut}.run();
+
+    std::ostringstream out;
+    EXPECT_EQ(Jit(unit, out).run(), expected);
+    EXPECT_EQ(out.str(), expectedOut.str());
+}
+
+TEST(JitTests, PrintlnEvaluatesEveryArgument)
+{
+    const ast::Unit unit = parse(printlnArgumentsSource);
+
+    std::ostringstream expectedOut;
+    std::ignore = interpreter::Interpreter {unit, expectedOut}.run();
+
+    std::ostringstream out;
+    std::ignore = Jit(unit, out).run();
+    EXPECT_EQ(out.str(), expectedOut.str());
+}
+
+TEST(JitTests, OverflowSameAsInterpreter)
+{
+    const ast::Unit unit = parse(overflowSource);
+
+    std::ostringstream expectedOut;
+    const interpreter::Value expected = interpreter::Interpreter {unit, expectedOut}.run();
+
+    std::ostringstream out;
+    EXPECT_EQ(Jit(unit, out).run(), expected);
+    EXPECT_EQ(out.str(), expectedOut.str());
+}
+
+TEST(JitTests, Errors)
+{
+    std::ostringstream out;
+
+    EXPECT_THROW(Jit(parse("fn main() { missing(1) }"), out), std::runtime_error);
+    EXPECT_THROW(Jit(parse("fn main() { println(\"{} {}\", 1) }"), out), std::runtime_error);
+
+    const ast::Unit unit = parse("fn divide(a, b) { a / b }");
+    Jit jit {unit, out};
+    EXPECT_THROW(std::ignore = jit.call("other"), std::runtime_error);
+    EXPECT_THROW(std::ignore = jit.call("divide"), std::runtime_error);
+
+    const Value args[] {1, 0};
+    EXPECT_EXIT(std::ignore = jit.call("divide", args), testing::ExitedWithCode(1), "Division by zero");
+}
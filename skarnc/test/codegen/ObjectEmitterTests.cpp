@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "TestUnits.h"
+#include "codegen/IrGenerator.h"
+#include "codegen/ObjectEmitter.h"
+#include "codegen/Optimizer.h"
+#include <llvm/ADT/SmallString.h>
+
+using namespace std::string_view_literals;
+using namespace skarn;
+using namespace skarn::codegen;
+using namespace skarn::test;
+
+TEST(ObjectEmitterTests, EntryPoint)
+{
+    llvm::LLVMContext context;
+
+    const std::unique_ptr<llvm::Module> library = generate_ir(parse("fn fib(n) { n }"), context);
+    EXPECT_FALSE(add_entry_point(*library));
+    EXPECT_EQ(library->getFunction("main"), nullptr);
+
+    const std::unique_ptr<llvm::Module> program = generate_ir(parse(fibSource), context);
+    EXPECT_TRUE(add_entry_point(*program));
+    ASSERT_NE(program->getFunction("main"), nullptr);
+    EXPECT_TRUE(program->getFunction("main")->getReturnType()->isIntegerTy(32));
+
+    const std::unique_ptr<llvm::Module> invalid = generate_ir(parse("fn main(n) { n }"), context);
+    EXPECT_THROW(std::ignore = add_entry_point(*invalid), std::runtime_error);
+}
+
+TEST(ObjectEmitterTests, Emit)
+{
+    for (const llvm::OptimizationLevel& level : {llvm::OptimizationLevel::O0, llvm::OptimizationLevel::O3}) {
+        llvm::LLVMContext context;
+        const std::unique_ptr<llvm::Module> module = generate_ir(parse(fibSource), context);
+        ASSERT_TRUE(add_entry_point(*module));
+
+        const std::unique_ptr<llvm::TargetMachine> machine = create_target_machine(*module, level);
+        optimize(*module, level, machine.get());
+
+        llvm::SmallString<0> assembly;
+        llvm::raw_svector_ostream assembly_out {assembly};
+        emit(*module, *machine, assembly_out, FileType::Assembly);
+        EXPECT_NE(assembly.str().find("skarn.fib"), llvm::StringRef::npos);
+        EXPECT_NE(assembly.str().find("main"), llvm::StringRef::npos);
+
+        llvm::SmallString<0> object;
+        llvm::raw_svector_ostream object_out {object};
+        emit(*module, *machine, object_out, FileType::Object);
+        EXPECT_FALSE(object.empty());
+    }
+}
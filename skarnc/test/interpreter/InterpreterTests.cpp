@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include "TestUnits.h"
+#include "interpreter/Interpreter.h"
+#include <sstream>
+
+using namespace std::string_view_literals;
+using namespace skarn;
+using namespace skarn::interpreter;
+using namespace skarn::test;
+
+TEST(InterpreterTests, Example)
+{
+    const ast::Unit unit = parse(fibSource);
+    std::ostringstream out;
+    Interpreter interpreter {unit, out};
+    EXPECT_EQ(interpreter.run(), 0);
+    EXPECT_EQ(out.str(), "fib(5)=5\n");
+
+    const Value args[] {40};
+    EXPECT_EQ(interpreter.call("fib", args), 102334155);
+}
+
+TEST(InterpreterTests, Recursion)
+{
+    const ast::Unit unit = parse(recursiveFibSource);
+
+    std::ostringstream out;
+    Interpreter interpreter {unit, out};
+    const Value args[] {20};
+    EXPECT_EQ(interpreter.call("fib", args), 6765);
+}
+
+TEST(InterpreterTests, Return)
+{
+    const ast::Unit unit = parse(R"(
+        fn first_square_above(limit) {
+            let i = 0;
+            while 1 {
+                if_true(i * i > limit);
+                while i * i > limit {
+                    return i;
+                }
+
+                i = i + 1;
+            }
+
+            0 - 1
+        }
+
+        fn if_true(x) {
+            x
+        }
+
+        fn main() {
+            -first_square_above(50) * 2 + (3 - 1) / 2
+        }
+    )");
+
+    std::ostringstream out;
+    Interpreter interpreter {unit, out};
+    EXPECT_EQ(interpreter.run(), -15);
+    EXPECT_TRUE(out.str().empty());
+}
+
+TEST(InterpreterTests, ReturnKeywordBoundary)
+{
+    const ast::Unit unit = parse(R"(
+        fn returnCode(x) {
+            println("code {}", x);
+            x
+        }
+
+        fn main() {
+            returnCode(1);
+            let returnValue = 3;
+            return(returnValue - 4);
+        }
+    )");
+
+    std::ostringstream out;
+    Interpreter interpreter {unit, out};
+    EXPECT_EQ(interpreter.run(), -1);
+    EXPECT_EQ(out.str(), "code 1\n"sv);
+}
+
+TEST(InterpreterTests, Overflow)
+{
+    const ast::Unit unit = parse(overflowSource);
+    std::ostringstream out;
+    EXPECT_EQ(Interpreter(unit, out).run(), 0);
+    EXPECT_EQ(out.str(), "-9223372036854775808 9223372036854775807 -9223372036854775808 -9223372036854775808\n"sv);
+}
+
+TEST(InterpreterTests, Errors)
+{
+    std::ostringstream out;
+
+    const ast::Unit division = parse("fn main() { 1 / (1 - 1) }");
+    EXPECT_THROW(std::ignore = Interpreter(division, out).run(), std::runtime_error);
+
+    const ast::Unit unknown = parse("fn main() { missing(1) }");
+    EXPECT_THROW(std::ignore = Interpreter(unknown, out).run(), std::runtime_error);
+
+    const ast::Unit overflow = parse("fn main() { main() }");
+    EXPECT_THROW(std::ignore = Interpreter(overflow, out, 1000).run(), std::runtime_error);
+
+    auto undefined = ast::parse_unit("fn main() { x }");
+    ASSERT_TRUE(undefined);
+    EXPECT_THROW(ast::resolve_slots(*undefined), std::runtime_error);
+}
+
+TEST(InterpreterTests, DeepRecursion)
+{
+    const ast::Unit unit = parse("fn f(n) { f(n + 1) }");
+
+    std::ostringstream out;
+    Interpreter interpreter {unit, out};
+    const Value args[] {0};
+    EXPECT_THROW(std::ignore = interpreter.call("f", args), std::runtime_error);
+
+    const ast::Unit countdown = parse(countdownSource);
+
+    Interpreter deep {countdown, out};
+    const Value depth[] {1000};
+    EXPECT_EQ(deep.call("countdown", depth), 0);
+}
+
+TEST(InterpreterTests, StackIsRestoredAfterError)
+{
+    const ast::Unit unit = parse(R"(
+        fn divide(n, d) {
+            while n > 0 {
+                return divide(n - 1, d);
+            }
+
+            1 / d
+        }
+    )");
+
+    std::ostringstream out;
+    Interpreter interpreter {unit, out, 16};
+    for (int i = 0; i < 10; ++i) {
+        const Value args[] {3, 0};
+        try {
+            std::ignore = interpreter.call("divide", args);
+            ADD_FAILURE() << "expected an error";
+        }
+        catch (const std::runtime_error& e) {
+            EXPECT_EQ(e.what(), "Division by zero"sv);
+        }
+    }
+
+    const Value args[] {3, 1};
+    EXPECT_EQ(interpreter.call("divide", args), 1);
+}
+
+TEST(InterpreterTests, ParseError)
+{
+    const auto unit = ast::parse_unit("fn main() {\n    let x = ;\n}");
+    ASSERT_FALSE(unit);
+    ASSERT_EQ(unit.error().size(), 1);
+    EXPECT_EQ(unit.error()[0].line, 2);
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include "parser/details/CaptureParser.h"
+#include "parser/details/CharParser.h"
+#include "parser/details/CharPredicateParser.h"
+#include "parser/details/CombinedParser.h"
+#include "parser/details/SequenceParser.h"
+
+using namespace std::string_view_literals;
+using namespace skarn::parser;
+
+namespace {
+constexpr auto digitPredicate = [](const char c) static noexcept {
+    return c >= '0' && c <= '9';
+};
+} // namespace
+
+TEST(CaptureParserTests, Success)
+{
+    constexpr auto parser = CaptureParser {makeCombinedParser(
+        CharParser {'a'}, SequenceParser {CharPredicateParser {digitPredicate, "digit"sv}})};
+
+    constexpr std::string_view input {"a123;"sv};
+    ParserContext<char> ctx {input};
+    std::string_view value;
+    ASSERT_TRUE(parser.parse(ctx, value));
+    EXPECT_EQ(value, "a123"sv);
+    EXPECT_EQ(value.data(), input.data()); // refers to the input
+    EXPECT_TRUE(ctx.messages().empty());
+    EXPECT_EQ(std::string_view {ctx.input()}, ";"sv);
+}
+
+TEST(CaptureParserTests, Offset)
+{
+    constexpr auto parser = CaptureParser {SequenceParser {CharPredicateParser {digitPredicate, "digit"sv}}};
+
+    constexpr std::string_view input {"x42"sv};
+    ParserContext<char> ctx {input};
+    ctx.consume(1);
+    std::string_view value;
+    ASSERT_TRUE(parser.parse(ctx, value));
+    EXPECT_EQ(value, "42"sv);
+    EXPECT_EQ(value.data(), input.data() + 1);
+}
+
+TEST(CaptureParserTests, InvalidInput)
+{
+    constexpr auto parser = CaptureParser {CharParser {'a'}};
+
+    constexpr std::string_view input {"b"sv};
+    ParserContext<char> ctx {input};
+    std::string_view value;
+    ASSERT_FALSE(parser.parse(ctx, value));
+    EXPECT_TRUE(value.empty());
+
+    const auto& messages = ctx.messages();
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0].code, ParserMsgCode::C0002);
+}
@@ -53,3 +53,19 @@ TEST(CharParserTests, InvalidInput) {
     EXPECT_EQ(messages[0].line, 1U);
     EXPECT_EQ(messages[0].column, 1U);
 }
+
+TEST(CharParserTests, MessageRecord) {
+    constexpr CharParser parser {'a'};
+
+    constexpr std::string_view input {"b"sv};
+    ParserContext<char> ctx {input};
+    ASSERT_FALSE(parser.parse(ctx));
+
+    const auto& records = ctx.message_records();
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].code, ParserMsgCode::C0002);
+    EXPECT_EQ(records[0].format, "'{}'"sv);
+    EXPECT_TRUE(records[0].what.empty());
+    EXPECT_EQ(std::get<char>(records[0].args[0]), 'a');
+    EXPECT_EQ(records[0].text(), "'a'"sv);
+}
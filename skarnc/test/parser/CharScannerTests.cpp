@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include "parser/details/CharScanner.h"
+#include <string>
+
+using namespace std::string_view_literals;
+using namespace skarn::parser;
+
+namespace {
+constexpr auto identPredicate = [](const char c) static noexcept {
+    return c >= 'a' && c <= 'z' || c >= 'A' && c <= 'Z' || c >= '0' && c <= '9' || c == '_';
+};
+
+constexpr auto oddPredicate = [](const char c) static noexcept {
+    return (static_cast<unsigned char>(c) & 1) != 0;
+};
+
+size_t scanReference(const std::string_view input, const CharSet& chars) {
+    size_t length = 0;
+    while (length < input.size() && chars.contains(input[length])) {
+        ++length;
+    }
+
+    return length;
+}
+} // namespace
+
+TEST(CharScannerTests, Ranges) {
+    constexpr CharScanner ident {CharSet::of(identPredicate)};
+    static_assert(ident.range_count() == 4);
+
+    constexpr CharScanner ws {CharSet::of(' ') | CharSet::of('\t') | CharSet::of('\n') | CharSet::of('\r')};
+    static_assert(ws.range_count() == 3);
+
+    constexpr CharScanner odd {CharSet::of(oddPredicate)};
+    static_assert(odd.range_count() == 0);
+
+    constexpr CharScanner all {CharSet::all()};
+    static_assert(all.range_count() == 1);
+}
+
+TEST(CharScannerTests, Empty) {
+    constexpr CharScanner scanner {CharSet::of(identPredicate)};
+    EXPECT_EQ(scanner.scan(""sv), 0U);
+    EXPECT_EQ(scanner.scan("+abc"sv), 0U);
+}
+
+TEST(CharScannerTests, AllLengths) {
+    constexpr CharSet identChars = CharSet::of(identPredicate);
+    constexpr CharSet oddChars = CharSet::of(oddPredicate);
+    constexpr CharScanner ident {identChars};
+    constexpr CharScanner odd {oddChars};
+    constexpr CharScanner all {CharSet::all()};
+
+    for (size_t length = 0; length < 100; ++length) {
+        std::string input;
+        for (size_t i = 0; i < length; ++i) {
+            input += "aZ09_q"[i % 6];
+        }
+
+        const std::string matchingAll = input;
+        input += "\x80 tail"sv;
+
+        EXPECT_EQ(ident.scan(input), length);
+        EXPECT_EQ(ident.scan(matchingAll), length);
+        EXPECT_EQ(odd.scan(input), scanReference(input, oddChars));
+        EXPECT_EQ(all.scan(input), input.size());
+    }
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "parser/Parser.h"
+#include <algorithm>
+#include <string>
+
+using namespace std::string_view_literals;
+using namespace skarn::parser;
+
+namespace {
+InputReader<char> string_reader(const std::string_view source) {
+    return [source, offset = size_t {0}](const std::span<char> buffer) mutable {
+        const size_t count = std::min(buffer.size(), source.size() - offset);
+        std::ranges::copy(source.substr(offset, count), buffer.begin());
+        offset += count;
+        return count;
+    };
+}
+
+constexpr auto integers = *(Parse::integer<int>() >> ~Parse::char_(','));
+} // namespace
+
+TEST(ChunkedInputTests, ListOfIntegers) {
+    ParserContext<char> ctx {string_reader("1,22,333,4444,55555,"sv), 8};
+    const auto result = integers.parse(ctx);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result.value(), (std::vector<int> {1, 22, 333, 4444, 55555}));
+    EXPECT_TRUE(ctx.input().empty());
+}
+
+TEST(ChunkedInputTests, BacktrackAcrossChunks) {
+    constexpr auto parser =
+        (Parse::literal("ab"sv) >> ~Parse::char_('c')) ||
+        (Parse::literal("ab"sv) >> ~Parse::char_('d'));
+
+    ParserContext<char> ctx {string_reader("abd"sv), 2};
+    const auto result = parser.parse(ctx);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result.value(), "ab"sv);
+    EXPECT_TRUE(ctx.input().empty());
+}
+
+TEST(ChunkedInputTests, CaptureAcrossChunks) {
+    constexpr auto parser = (+Parse::char_([](const char c) static noexcept {
+        return c >= 'a' && c <= 'z' || c == '_';
+    })).capture();
+
+    ParserContext<char> ctx {string_reader("long_identifier_name;"sv), 4};
+    const auto result = parser.parse(ctx);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result.value(), "long_identifier_name"sv);
+}
+
+TEST(ChunkedInputTests, MemoryIsBoundedByBacktrackDistance) {
+    std::string source;
+    for (int i = 0; i < 10000; ++i) {
+        source += std::to_string(i);
+        source += ',';
+    }
+
+    ParserContext<char>* context = nullptr;
+    size_t max_buffered = 0;
+    InputReader<char> reader = [&context, &max_buffered, read = string_reader(source)](const std::span<char> buffer) mutable {
+        max_buffered = std::max(max_buffered, context->buffered_size());
+        return read(buffer);
+    };
+
+    ParserContext<char> ctx {std::move(reader), 16};
+    context = &ctx;
+    const auto result = integers.parse(ctx);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result.value().size(), 10000U);
+    EXPECT_LT(max_buffered, 128U);
+}
+
+TEST(ChunkedInputTests, MessageLocationAfterRelease) {
+    std::string source;
+    for (int i = 0; i < 100; ++i) {
+        source += "12\n";
+    }
+
+    source += "  x";
+
+    constexpr auto parser = *(Parse::integer<int>() >> ~Parse::char_('\n')) >> ~Parse::literal("  y"sv);
+    ParserContext<char> ctx {string_reader(source), 8};
+    const auto result = parser.parse(ctx);
+    ASSERT_FALSE(result);
+
+    const auto& messages = result.error();
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0].offset, 300U);
+    EXPECT_EQ(messages[0].line, 101U);
+    EXPECT_EQ(messages[0].column, 1U);
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include "parser/Parser.h"
+
+using namespace std::string_view_literals;
+using namespace skarn::parser;
+
+namespace {
+template <class Parser>
+constexpr FirstSet first_set(const ParserInterface<Parser>& parser) noexcept {
+    return details::first_set_of(parser.parser());
+}
+
+constexpr auto letterPredicate = [](const char c) static noexcept {
+    return c >= 'a' && c <= 'z';
+};
+} // namespace
+
+TEST(FirstSetTests, Leaves) {
+    static_assert(first_set(Parse::char_('a')) == FirstSet {CharSet::of('a'), false});
+    static_assert(first_set(Parse::literal("let"sv)) == FirstSet {CharSet::of('l'), false});
+    static_assert(first_set(Parse::literal(""sv)) == FirstSet::empty());
+    static_assert(first_set(Parse::char_(letterPredicate)) == FirstSet {CharSet::range('a', 'z'), false});
+    static_assert(first_set(Parse::integer<unsigned>()) == FirstSet {CharSet::range('0', '9'), false});
+    static_assert(first_set(Parse::integer<int>()) == FirstSet {CharSet::range('0', '9') | CharSet::of('-'), false});
+    static_assert(first_set(Parse::value(1)) == FirstSet::empty());
+    static_assert(first_set(Parse::ref<int>()) == FirstSet::any());
+}
+
+TEST(FirstSetTests, Combinators) {
+    static_assert(first_set(Parse::char_('a') >> Parse::char_('b')) == FirstSet {CharSet::of('a'), false});
+    static_assert(first_set(*~Parse::char_(' ') >> Parse::char_('b')) ==
+        FirstSet {CharSet::of(' ') | CharSet::of('b'), false});
+    static_assert(first_set(*Parse::char_('a') >> Parse::char_('b').optional()) ==
+        FirstSet {CharSet::of('a') | CharSet::of('b'), true});
+    static_assert(first_set(+Parse::char_('a')) == FirstSet {CharSet::of('a'), false});
+    static_assert(first_set(Parse::char_('a') || Parse::literal("bc"sv)) ==
+        FirstSet {CharSet::of('a') | CharSet::of('b'), false});
+    static_assert(first_set(Parse::char_('a').expected("letter a"sv).value(1)) == FirstSet {CharSet::of('a'), false});
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include "parser/details/CharParser.h"
+#include "parser/details/LineIndex.h"
+
+using namespace std::string_view_literals;
+using namespace skarn::parser;
+
+TEST(LineIndexTests, SingleLine) {
+    constexpr std::string_view input {"abc"sv};
+    const LineIndex index {input};
+    EXPECT_EQ(index.line_count(), 1U);
+
+    const SourceLocation location = index.location(2);
+    EXPECT_EQ(location.line, 1U);
+    EXPECT_EQ(location.column, 3U);
+}
+
+TEST(LineIndexTests, MultipleLines) {
+    constexpr std::string_view input {"fn main() {\n    let a = 1;\n\n    a\n}\n"sv};
+    const LineIndex index {input};
+    EXPECT_EQ(index.line_count(), 6U);
+
+    const SourceLocation first = index.location(0);
+    EXPECT_EQ(first.line, 1U);
+    EXPECT_EQ(first.column, 1U);
+
+    const SourceLocation let = index.location(input.find("let"));
+    EXPECT_EQ(let.line, 2U);
+    EXPECT_EQ(let.column, 5U);
+
+    const SourceLocation newline = index.location(input.find(';') + 1);
+    EXPECT_EQ(newline.line, 2U);
+    EXPECT_EQ(newline.column, 15U);
+
+    const SourceLocation last = index.location(input.rfind('}'));
+    EXPECT_EQ(last.line, 5U);
+    EXPECT_EQ(last.column, 1U);
+
+    const SourceLocation end = index.location(input.size());
+    EXPECT_EQ(end.line, 6U);
+    EXPECT_EQ(end.column, 1U);
+}
+
+TEST(LineIndexTests, LongLines) {
+    std::string input;
+    for (size_t i = 0; i < 100; ++i) {
+        input.append(i % 37, 'x');
+        input += '\n';
+    }
+
+    const LineIndex index {input};
+    EXPECT_EQ(index.line_count(), 101U);
+
+    size_t offset = 0;
+    for (size_t i = 0; i < 100; ++i) {
+        const SourceLocation location = index.location(offset + i % 37);
+        EXPECT_EQ(location.line, i + 1);
+        EXPECT_EQ(location.column, i % 37 + 1);
+        offset += i % 37 + 1;
+    }
+}
+
+TEST(LineIndexTests, MessageLocation) {
+    constexpr CharParser parser {'a'};
+
+    constexpr std::string_view input {"\n\n  b"sv};
+    ParserContext<char> ctx {input};
+    ctx.consume(4);
+    ASSERT_FALSE(parser.parse(ctx));
+
+    const auto& messages = ctx.messages();
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0].offset, 4);
+    EXPECT_EQ(messages[0].line, 3U);
+    EXPECT_EQ(messages[0].column, 3U);
+}
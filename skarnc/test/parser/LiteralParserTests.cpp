@@ -56,3 +56,33 @@ TEST(LiteralParserTests, InvalidInput)
     EXPECT_EQ(messages[0].line, 1U);
     EXPECT_EQ(messages[0].column, 1U);
 }
+
+TEST(LiteralParserTests, Keyword)
+{
+    constexpr KeywordParser parser {"return"sv};
+
+    ParserContext<char> ctx {"return(x)"sv};
+    std::string_view value;
+    ASSERT_TRUE(parser.parse(ctx, value));
+    EXPECT_EQ(value, "return"sv);
+    EXPECT_EQ(std::string_view {ctx.input()}, "(x)"sv);
+
+    ParserContext<char> end {"return"sv};
+    EXPECT_TRUE(parser.parse(end, value));
+}
+
+TEST(LiteralParserTests, KeywordPrefixOfIdentifier)
+{
+    constexpr KeywordParser parser {"return"sv};
+
+    constexpr std::string_view input {"returnCode(1);"sv};
+    ParserContext<char> ctx {input};
+    std::string_view value;
+    ASSERT_FALSE(parser.parse(ctx, value));
+    EXPECT_EQ(std::string_view {ctx.input()}, input);
+
+    const auto& messages = ctx.messages();
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0].code, ParserMsgCode::C0002);
+    EXPECT_EQ(messages[0].expected, "'return'"sv);
+}
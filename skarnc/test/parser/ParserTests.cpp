@@ -70,3 +70,57 @@ TEST(ParserTests, ListOfIntegers) {
     EXPECT_EQ(ints[4], 0);
     EXPECT_EQ(ints[5], 1);
 }
+
+TEST(ParserTests, FarthestFailure) {
+    constexpr auto parser =
+        Parse::char_('a') >> Parse::char_('b') ||
+        Parse::char_('a') >> Parse::char_('c') ||
+        Parse::char_('d');
+
+    ParserContext<char> ctx {"ax"sv};
+    ctx.error_mode(ParserErrorMode::Farthest);
+    const auto result = parser.parse(ctx);
+    ASSERT_FALSE(result);
+
+    const auto& messages = result.error();
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0].level, ParserMsgLevel::Error);
+    EXPECT_EQ(messages[0].code, ParserMsgCode::C0002);
+    EXPECT_EQ(messages[0].expected, "'b' or 'c'"sv);
+    EXPECT_EQ(messages[0].offset, 1);
+    EXPECT_EQ(messages[0].line, 1U);
+    EXPECT_EQ(messages[0].column, 2U);
+}
+
+TEST(ParserTests, FarthestFailureExpected) {
+    constexpr auto letter = (Parse::char_('x') || Parse::char_('y')).expected("letter"sv);
+    constexpr auto parser = ~Parse::char_('(') >> *~Parse::ws() >> (letter || Parse::integer()) >> ~Parse::char_(')');
+
+    ParserContext<char> ctx {"(\n  +"sv};
+    ctx.error_mode(ParserErrorMode::Farthest);
+    const auto result = parser.parse(ctx);
+    ASSERT_FALSE(result);
+
+    const auto& messages = result.error();
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0].expected, "whitespace, letter or an integer"sv);
+    EXPECT_EQ(messages[0].offset, 4);
+    EXPECT_EQ(messages[0].line, 2U);
+    EXPECT_EQ(messages[0].column, 3U);
+}
+
+TEST(ParserTests, FarthestFailureBounded) {
+    constexpr auto parser = *(Parse::char_('a') || Parse::char_('b')) >> Parse::char_('c');
+
+    const std::string input(1000, 'a');
+    ParserContext<char> ctx {input};
+    ctx.error_mode(ParserErrorMode::Farthest);
+    ASSERT_FALSE(parser.parse(ctx));
+    EXPECT_EQ(ctx.message_records().size(), 3);
+
+    const auto messages = ctx.messages();
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0].code, ParserMsgCode::C0001);
+    EXPECT_EQ(messages[0].expected, "'a', 'b' or 'c'"sv);
+    EXPECT_EQ(messages[0].offset, 1000);
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "parser/Parser.h"
+
+using namespace std::string_view_literals;
+using namespace skarn::parser;
+
+namespace {
+constexpr auto calculate = [](int& result, const char op, int& rhs) static {
+    switch (op) {
+        case '+':
+            result += rhs;
+            break;
+        case '-':
+            result -= rhs;
+            break;
+        case '*':
+            result *= rhs;
+            break;
+        case '^': {
+            int power = 1;
+            for (int i = 0; i < rhs; ++i) {
+                power *= result;
+            }
+
+            result = power;
+            break;
+        }
+        default:
+            break;
+    }
+};
+
+constexpr auto calculator = Parse::precedence(Parse::integer<int>(), calculate,
+    Parse::left(Parse::char_('+') || Parse::char_('-')),
+    Parse::left(Parse::char_('*')),
+    Parse::right(Parse::char_('^')));
+} // namespace
+
+TEST(PrecedenceParserTests, Precedence)
+{
+    EXPECT_EQ(calculator.parse("1+2*3"sv).value(), 7);
+    EXPECT_EQ(calculator.parse("2*3+1"sv).value(), 7);
+    EXPECT_EQ(calculator.parse("2*3^2+1"sv).value(), 19);
+    EXPECT_EQ(calculator.parse("1+2*3^2*2-4"sv).value(), 33);
+}
+
+TEST(PrecedenceParserTests, Associativity)
+{
+    EXPECT_EQ(calculator.parse("10-4-3"sv).value(), 3);
+    EXPECT_EQ(calculator.parse("2^3^2"sv).value(), 512);
+}
+
+TEST(PrecedenceParserTests, OperatorWithoutOperand)
+{
+    ParserContext<char> ctx {"1+2*"sv};
+    int value {};
+    ASSERT_TRUE(calculator.parser().parse(ctx, value));
+    EXPECT_EQ(value, 3);
+    EXPECT_EQ(std::string_view {ctx.input()}, "*"sv);
+    EXPECT_TRUE(ctx.messages().empty());
+}
+
+TEST(PrecedenceParserTests, InvalidInput)
+{
+    ParserContext<char> ctx {"+1"sv};
+    int value {};
+    ASSERT_FALSE(calculator.parser().parse(ctx, value));
+    EXPECT_FALSE(ctx.messages().empty());
+}
+
+TEST(PrecedenceParserTests, NoValue)
+{
+    ParserContext<char> ctx {"1+2*3-"sv};
+    ASSERT_TRUE(calculator.parser().parse(ctx));
+    EXPECT_EQ(std::string_view {ctx.input()}, "-"sv);
+}
+
+TEST(PrecedenceParserTests, LongChain)
+{
+    std::string input {"1"};
+    for (size_t i = 0; i < 10000; ++i) {
+        input += "+1";
+    }
+
+    EXPECT_EQ(calculator.parse(input).value(), 10001);
+}
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include "parser/Parser.h"
 #include "parser/details/IntParser.h"
 #include "parser/details/ReferenceParser.h"
 
@@ -19,3 +20,54 @@ TEST(ReferenceParserTests, Success)
     EXPECT_TRUE(ctx.messages().empty());
     EXPECT_TRUE(ctx.input().empty());
 }
+
+TEST(ReferenceParserTests, PackratSuccessHit)
+{
+    constexpr ParserInterface<ReferenceParser<int, char, struct PackratSuccessTag>> parser;
+    parser.assign(Parse::integer<int>());
+
+    constexpr auto grammar = (parser >> 'x') || (parser >> 'y');
+
+    ParserContext<char> ctx {"123y"sv};
+    ctx.packrat(true);
+    const auto result = grammar.parse(ctx);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(std::get<0>(result.value()), 123);
+    EXPECT_EQ(std::get<1>(result.value()), 'y');
+    EXPECT_TRUE(ctx.input().empty());
+
+    const PackratStats stats = ctx.packrat_stats();
+    EXPECT_EQ(stats.hits, 1U);
+    EXPECT_EQ(stats.misses, 1U);
+}
+
+TEST(ReferenceParserTests, PackratFailureHit)
+{
+    constexpr ParserInterface<ReferenceParser<int, char, struct PackratFailureTag>> parser;
+    parser.assign(Parse::integer<int>());
+
+    constexpr auto grammar = (parser >> 'x') || (parser >> 'y') || Parse::char_('z');
+
+    ParserContext<char> ctx {"abc"sv};
+    ctx.packrat(true);
+    ASSERT_FALSE(grammar.parse(ctx));
+
+    const PackratStats stats = ctx.packrat_stats();
+    EXPECT_EQ(stats.hits, 1U);
+    EXPECT_EQ(stats.misses, 1U);
+}
+
+TEST(ReferenceParserTests, PackratDisabled)
+{
+    constexpr ParserInterface<ReferenceParser<int, char, struct PackratDisabledTag>> parser;
+    parser.assign(Parse::integer<int>());
+
+    constexpr auto grammar = (parser >> 'x') || (parser >> 'y');
+
+    ParserContext<char> ctx {"123y"sv};
+    ASSERT_TRUE(grammar.parse(ctx));
+
+    const PackratStats stats = ctx.packrat_stats();
+    EXPECT_EQ(stats.hits, 0U);
+    EXPECT_EQ(stats.misses, 0U);
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "parser/Parser.h"
+#include "parser/details/RuleParser.h"
+
+using namespace std::string_view_literals;
+using namespace skarn::parser;
+
+namespace {
+struct IntRule {
+    static constexpr auto definition = Parse::integer<int>();
+};
+
+struct NestedRule;
+
+constexpr auto nestedRule = Parse::rule<NestedRule, int>();
+constexpr auto nested = (~Parse::char_('(') >> nestedRule >> ~Parse::char_(')')) || Parse::integer<int>();
+
+struct NestedRule {
+    static constexpr auto definition = nested;
+};
+} // namespace
+
+TEST(RuleParserTests, Success)
+{
+    constexpr RuleParser<IntRule, int> parser;
+
+    constexpr std::string_view input {"-123"sv};
+    ParserContext<char> ctx {input};
+    int value {};
+    ASSERT_TRUE(parser.parse(ctx, value));
+    EXPECT_EQ(value, -123);
+    EXPECT_TRUE(ctx.messages().empty());
+    EXPECT_TRUE(ctx.input().empty());
+}
+
+TEST(RuleParserTests, Recursive)
+{
+    const auto result = nestedRule.parse("(((42)))"sv);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result.value(), 42);
+}
+
+TEST(RuleParserTests, RecursiveFailure)
+{
+    EXPECT_FALSE(nestedRule.parse("((42)"sv));
+}
+
+TEST(RuleParserTests, PackratSuccessHit)
+{
+    constexpr auto parser = Parse::rule<IntRule, int>();
+    constexpr auto grammar = (parser >> 'x') || (parser >> 'y');
+
+    ParserContext<char> ctx {"123y"sv};
+    ctx.packrat(true);
+    const auto result = grammar.parse(ctx);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(std::get<0>(result.value()), 123);
+    EXPECT_EQ(std::get<1>(result.value()), 'y');
+    EXPECT_TRUE(ctx.input().empty());
+
+    const PackratStats stats = ctx.packrat_stats();
+    EXPECT_EQ(stats.hits, 1U);
+    EXPECT_EQ(stats.misses, 1U);
+}
+
+TEST(RuleParserTests, PackratDisabled)
+{
+    constexpr auto parser = Parse::rule<IntRule, int>();
+    constexpr auto grammar = (parser >> 'x') || (parser >> 'y');
+
+    ParserContext<char> ctx {"123y"sv};
+    ASSERT_TRUE(grammar.parse(ctx));
+
+    const PackratStats stats = ctx.packrat_stats();
+    EXPECT_EQ(stats.hits, 0U);
+    EXPECT_EQ(stats.misses, 0U);
+}
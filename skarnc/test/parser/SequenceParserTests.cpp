@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include "parser/details/CharPredicateParser.h"
+#include "parser/details/IgnoreParser.h"
 #include "parser/details/LiteralParser.h"
 #include "parser/details/SequenceParser.h"
 
@@ -81,3 +83,61 @@ TEST(SequenceParserTests, AtLeastOnceInvalidInput) {
     EXPECT_EQ(messages[0].line, 1U);
     EXPECT_EQ(messages[0].column, 1U);
 }
+
+namespace {
+constexpr auto letterPredicate = [](const char c) static noexcept {
+    return c >= 'a' && c <= 'z';
+};
+
+using LetterParser = CharPredicateParser<std::remove_const_t<decltype(letterPredicate)>>;
+} // namespace
+
+TEST(SequenceParserTests, ScanCharacters) {
+    constexpr SequenceParser parser {CharPredicateParser {letterPredicate, "letter"sv}};
+
+    const std::string input = std::string(100, 'x') + "abc1";
+    ParserContext<char> ctx {input};
+    std::string value;
+    ASSERT_TRUE(parser.parse(ctx, value));
+    EXPECT_EQ(value, std::string(100, 'x') + "abc");
+    EXPECT_TRUE(ctx.messages().empty());
+    EXPECT_EQ(std::string_view {ctx.input()}, "1"sv);
+}
+
+TEST(SequenceParserTests, ScanIgnoredCharacters) {
+    constexpr SequenceParser parser {IgnoreParser {CharPredicateParser {letterPredicate, "letter"sv}}};
+
+    constexpr std::string_view input {"abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz;"sv};
+    ParserContext<char> ctx {input};
+    ASSERT_TRUE(parser.parse(ctx));
+    EXPECT_TRUE(ctx.messages().empty());
+    EXPECT_EQ(std::string_view {ctx.input()}, ";"sv);
+}
+
+TEST(SequenceParserTests, ScanMaxCount) {
+    constexpr SequenceParser<LetterParser, 1, 2> parser {
+        LetterParser {letterPredicate, "letter"sv}};
+
+    constexpr std::string_view input {"abcd"sv};
+    ParserContext<char> ctx {input};
+    std::string value;
+    ASSERT_TRUE(parser.parse(ctx, value));
+    EXPECT_EQ(value, "abc"sv);
+    EXPECT_EQ(std::string_view {ctx.input()}, "d"sv);
+}
+
+TEST(SequenceParserTests, ScanRequiredCount) {
+    constexpr SequenceParser<LetterParser, 3> parser {
+        LetterParser {letterPredicate, "letter"sv}};
+
+    constexpr std::string_view input {"ab1"sv};
+    ParserContext<char> ctx {input};
+    std::string value;
+    ASSERT_FALSE(parser.parse(ctx, value));
+
+    const auto& messages = ctx.messages();
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0].code, ParserMsgCode::C0002);
+    EXPECT_EQ(messages[0].expected, "letter"sv);
+    EXPECT_EQ(messages[0].offset, 2);
+}
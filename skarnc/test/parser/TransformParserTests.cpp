@@ -66,3 +66,32 @@ TEST(TransformParserTests, InvalidInput)
     EXPECT_EQ(messages[0].line, 1U);
     EXPECT_EQ(messages[0].column, 1U);
 }
+
+TEST(TransformParserTests, UserData)
+{
+    constexpr TransformParser parser {CharParser {'a'},
+        [](ParserContext<char>& ctx, int& value, const char& c) static {
+            value = ctx.user_data<int>() + static_cast<unsigned char>(c);
+        }};
+
+    constexpr std::string_view input {"a"sv};
+    ParserContext<char> ctx {input};
+    int offset = 1;
+    ctx.user_data(offset);
+    int value {};
+    ASSERT_TRUE(parser.parse(ctx, value));
+    EXPECT_EQ(value, 'a' + 1);
+}
+
+TEST(TransformParserTests, MissingUserData)
+{
+    constexpr TransformParser parser {CharParser {'a'},
+        [](ParserContext<char>& ctx, int& value, [[maybe_unused]] const char& c) static {
+            value = ctx.user_data<int>();
+        }};
+
+    constexpr std::string_view input {"a"sv};
+    ParserContext<char> ctx {input};
+    int value {};
+    EXPECT_THROW(std::ignore = parser.parse(ctx, value), std::logic_error);
+}
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include "parser/details/CharParser.h"
 #include "parser/details/IntParser.h"
 #include "parser/details/LiteralParser.h"
 #include "parser/details/VariantParser.h"
@@ -73,3 +74,105 @@ TEST(VariantParserTests, InvalidInput)
     EXPECT_EQ(messages[0].line, 1U);
     EXPECT_EQ(messages[0].column, 1U);
 }
+
+namespace {
+struct CountingParser {
+    using ParserType = CountingParser;
+    using InputType = char;
+    using ValueType = char;
+
+    char chr;
+    int* calls;
+
+    [[nodiscard]] constexpr FirstSet first_set() const noexcept {
+        return FirstSet {CharSet::of(chr), false};
+    }
+
+    bool parse(ParserContext<char>& ctx, char& value) const {
+        ++*calls;
+        return CharParser {chr}.parse(ctx, value);
+    }
+
+    bool parse(ParserContext<char>& ctx) const {
+        ++*calls;
+        return CharParser {chr}.parse(ctx);
+    }
+};
+} // namespace
+
+TEST(VariantParserTests, DispatchSkipsAlternatives)
+{
+    int aCalls {};
+    int bCalls {};
+    const auto parser = makeVariantParser(CountingParser {'a', &aCalls}, CountingParser {'b', &bCalls}, CharParser {'c'});
+
+    constexpr std::string_view input {"c"sv};
+    ParserContext<char> ctx {input};
+    char value {};
+    ASSERT_TRUE(parser.parse(ctx, value));
+    EXPECT_EQ(value, 'c');
+    EXPECT_EQ(aCalls, 0);
+    EXPECT_EQ(bCalls, 0);
+    EXPECT_TRUE(ctx.input().empty());
+}
+
+TEST(VariantParserTests, DispatchKeepsFailureMessage)
+{
+    int aCalls {};
+    int bCalls {};
+    const auto parser = makeVariantParser(CharParser {'c'}, CountingParser {'a', &aCalls}, CountingParser {'b', &bCalls});
+
+    constexpr std::string_view input {"x"sv};
+    ParserContext<char> ctx {input};
+    ASSERT_FALSE(parser.parse(ctx));
+    EXPECT_EQ(aCalls, 0);
+    EXPECT_EQ(bCalls, 1);
+
+    const auto& messages = ctx.messages();
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0].expected, "'b'"sv);
+}
+
+TEST(VariantParserTests, DispatchDisabledInFarthestMode)
+{
+    int aCalls {};
+    int bCalls {};
+    const auto parser = makeVariantParser(CountingParser {'a', &aCalls}, CountingParser {'b', &bCalls}, CharParser {'c'});
+
+    constexpr std::string_view input {"x"sv};
+    ParserContext<char> ctx {input};
+    ctx.error_mode(ParserErrorMode::Farthest);
+    ASSERT_FALSE(parser.parse(ctx));
+    EXPECT_EQ(aCalls, 1);
+    EXPECT_EQ(bCalls, 1);
+
+    const auto& messages = ctx.messages();
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0].expected, "'a', 'b' or 'c'"sv);
+}
+
+TEST(VariantParserTests, DispatchPreservesOrder)
+{
+    constexpr auto parser = makeVariantParser(LiteralParser {"ab"sv}, LiteralParser {"a"sv}, LiteralParser {""sv});
+
+    {
+        ParserContext<char> ctx {"ab"sv};
+        std::string_view value;
+        ASSERT_TRUE(parser.parse(ctx, value));
+        EXPECT_EQ(value, "ab"sv);
+    }
+
+    {
+        ParserContext<char> ctx {"ac"sv};
+        std::string_view value;
+        ASSERT_TRUE(parser.parse(ctx, value));
+        EXPECT_EQ(value, "a"sv);
+    }
+
+    {
+        ParserContext<char> ctx {"x"sv};
+        std::string_view value;
+        ASSERT_TRUE(parser.parse(ctx, value));
+        EXPECT_EQ(value, ""sv);
+    }
+}